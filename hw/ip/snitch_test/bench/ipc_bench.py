@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+# Copyright 2023 ETH Zurich and University of Bologna.
+# Solderpad Hardware License, Version 0.51, see LICENSE for details.
+# SPDX-License-Identifier: SHL-0.51
+#
+# Throughput of the IPC transports of `SnitchSim`. Writes and reads back
+# `--size` bytes of simulation memory through the FIFOs and through the shared
+# region, both by copying through the window and by accessing the window in
+# place. The simulation runs `<snitch_bin>` in the meantime.
+
+import os
+import sys
+import time
+import argparse
+
+sys.path.append(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'src'))
+from SnitchSim import SnitchSim  # noqa: E402
+
+parser = argparse.ArgumentParser('ipc_bench', allow_abbrev=True)
+parser.add_argument('sim_bin', metavar='<sim_bin>', help='The simulator binary')
+parser.add_argument('snitch_bin', metavar='<snitch_bin>', help='The binary to simulate')
+parser.add_argument('--size', type=float, default=1, help='GiB to transfer per direction')
+parser.add_argument('--chunk', type=int, default=64, help='MiB per access')
+parser.add_argument('--addr', type=lambda x: int(x, 0), default=0xC0000000,
+                    help='Target address of the copied transfers')
+parser.add_argument('--shm-base', type=lambda x: int(x, 0), default=0xF0000000,
+                    help='Target address of the shared window')
+parser.add_argument('--no-fifo', action='store_true', help='Skip the FIFO transport')
+
+
+def measure(name, size, fn):
+    start = time.monotonic()
+    fn()
+    elapsed = time.monotonic() - start
+    print(f'{name:<32} {size / elapsed / 2**30:8.2f} GiB/s')
+
+
+def transfer(sim, addr, size, chunk, stride):
+    buf = os.urandom(chunk)
+
+    def write():
+        for i in range(size // chunk):
+            sim.write(addr + i * stride, buf)
+
+    def read():
+        for i in range(size // chunk):
+            sim.read(addr + i * stride, chunk)
+    return write, read
+
+
+def main():
+    args = parser.parse_args()
+    chunk = args.chunk << 20
+    size = int(args.size * 2**30) // chunk * chunk
+
+    if not args.no_fifo:
+        sim = SnitchSim(args.sim_bin, args.snitch_bin)
+        sim.start()
+        write, read = transfer(sim, args.addr, size, chunk, chunk)
+        measure('fifo write', size, write)
+        measure('fifo read', size, read)
+        sim.finish(wait_for_sim=False)
+
+    sim = SnitchSim(args.sim_bin, args.snitch_bin, shm_base=args.shm_base, shm_size=chunk)
+    sim.start()
+    write, read = transfer(sim, args.addr, size, chunk, chunk)
+    measure('shm write (copy)', size, write)
+    measure('shm read (copy)', size, read)
+    # In place: the data only moves once, between the client and the window
+    write, _ = transfer(sim, args.shm_base, size, chunk, 0)
+    out = memoryview(bytearray(chunk))
+
+    def read():
+        for _ in range(size // chunk):
+            out[:] = sim.window[:chunk]
+    measure('shm write (in place)', size, write)
+    measure('shm read (in place)', size, read)
+    sim.finish(wait_for_sim=False)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,146 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Solderpad Hardware License, Version 0.51, see LICENSE for details.
+// SPDX-License-Identifier: SHL-0.51
+
+// Microbenchmark of the simulation memory. Replays the access patterns of the
+// `tb_memory_read`/`tb_memory_write` DPI calls and reports bytes per second.
+// Given a binary, it also reports the time to preload its `PT_LOAD` segments
+// as `fesvr`'s strobed 8-byte chunks and as one write per segment.
+
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "tb_lib.hh"
+
+namespace {
+
+constexpr uint64_t BASE = 0x80000000;
+constexpr size_t REGION = 16 << 20;
+constexpr size_t TOTAL = 1 << 30;
+
+// Run `fn(addr)` for `TOTAL / beat` beats sweeping over `REGION` and print the
+// achieved throughput.
+template <typename F>
+void bench(const char *name, size_t beat, F fn) {
+    auto start = std::chrono::steady_clock::now();
+    uint64_t off = 0;
+    for (size_t done = 0; done < TOTAL; done += beat) {
+        fn(BASE + off);
+        off = (off + beat) % REGION;
+    }
+    std::chrono::duration<double> t = std::chrono::steady_clock::now() - start;
+    printf("%-24s %6zu B/beat %10.1f MiB/s\n", name, beat,
+           TOTAL / t.count() / (1 << 20));
+}
+
+// Write `len` bytes at `src` to `addr` in chunks of at most `chunk` bytes. With
+// a strobe, the last chunk is padded to `chunk` bytes as `fesvr` does.
+void write_chunked(sim::GlobalMemory &mem, uint64_t addr, const uint8_t *src,
+                   size_t len, size_t chunk, const uint8_t *strb) {
+    for (size_t off = 0; off < len; off += chunk) {
+        size_t n = std::min(chunk, len - off);
+        uint8_t tail[8] = {0};
+        if (strb && n < chunk) {
+            memcpy(tail, src + off, n);
+            mem.write(addr + off, chunk, tail, strb);
+        } else {
+            mem.write(addr + off, n, src + off, strb);
+        }
+    }
+}
+
+// Write the `PT_LOAD` segments of the ELF image `buf`, including their
+// zero-filled tails, as `write_chunked` does.
+template <typename Ehdr, typename Phdr>
+void preload(sim::GlobalMemory &mem, const uint8_t *buf, size_t chunk,
+             const uint8_t *strb) {
+    auto eh = reinterpret_cast<const Ehdr *>(buf);
+    auto ph = reinterpret_cast<const Phdr *>(buf + eh->e_phoff);
+    for (unsigned i = 0; i < eh->e_phnum; i++) {
+        if (ph[i].p_type != PT_LOAD) continue;
+        write_chunked(mem, ph[i].p_paddr, buf + ph[i].p_offset,
+                      ph[i].p_filesz, chunk, strb);
+        std::vector<uint8_t> zeros(ph[i].p_memsz - ph[i].p_filesz, 0);
+        write_chunked(mem, ph[i].p_paddr + ph[i].p_filesz, zeros.data(),
+                      zeros.size(), chunk, strb);
+    }
+}
+
+// Report the average time to preload the segments of `path`.
+void bench_preload(const char *path) {
+    int fd = open(path, O_RDONLY);
+    struct stat s;
+    if (fd < 0 || fstat(fd, &s) < 0) {
+        perror(path);
+        return;
+    }
+    void *map = mmap(nullptr, s.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror(path);
+        return;
+    }
+    auto buf = static_cast<const uint8_t *>(map);
+    bool elf64 = buf[EI_CLASS] == ELFCLASS64;
+    sim::GlobalMemory mem;
+    uint8_t strb[8] = {1, 1, 1, 1, 1, 1, 1, 1};
+    const int iterations = 1000;
+    for (auto chunk : {size_t(8), size_t(-1)}) {
+        const uint8_t *chunk_strb = chunk == 8 ? strb : nullptr;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            if (elf64)
+                preload<Elf64_Ehdr, Elf64_Phdr>(mem, buf, chunk, chunk_strb);
+            else
+                preload<Elf32_Ehdr, Elf32_Phdr>(mem, buf, chunk, chunk_strb);
+        }
+        std::chrono::duration<double, std::micro> t =
+            std::chrono::steady_clock::now() - start;
+        printf("preload, %-15s %10.1f us\n",
+               chunk == 8 ? "8-byte chunks" : "bulk", t.count() / iterations);
+    }
+    munmap(map, s.st_size);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    sim::GlobalMemory mem;
+    uint8_t data[64];
+    std::vector<uint8_t> full(64, 1), half(64, 0), none(64, 0);
+    for (int i = 0; i < 64; i++) {
+        data[i] = i;
+        half[i] = (i / 4) % 2;
+    }
+
+    // Wide DMA port.
+    bench("write, full strobe", 64,
+          [&](uint64_t a) { mem.write(a, 64, data, full.data()); });
+    bench("write, partial strobe", 64,
+          [&](uint64_t a) { mem.write(a, 64, data, half.data()); });
+    bench("write, empty strobe", 64,
+          [&](uint64_t a) { mem.write(a, 64, data, none.data()); });
+    bench("read", 64, [&](uint64_t a) { mem.read(a, 64, data); });
+    // Narrow core port.
+    bench("write, full strobe", 8,
+          [&](uint64_t a) { mem.write(a, 8, data, full.data()); });
+    bench("write, partial strobe", 8,
+          [&](uint64_t a) { mem.write(a, 8, data, half.data()); });
+    bench("read", 8, [&](uint64_t a) { mem.read(a, 8, data); });
+    // Bulk ELF segment preloading.
+    std::vector<uint8_t> segment(512 << 10, 0xab);
+    bench("write, no strobe", segment.size(), [&](uint64_t a) {
+        mem.write(a, segment.size(), segment.data(), nullptr);
+    });
+    if (argc > 1) bench_preload(argv[1]);
+    return 0;
+}
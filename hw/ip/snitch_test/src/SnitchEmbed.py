@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+# Copyright 2023 ETH Zurich and University of Bologna.
+# Solderpad Hardware License, Version 0.51, see LICENSE for details.
+# SPDX-License-Identifier: SHL-0.51
+#
+# This class runs the Verilator testbench inside the Python process through
+# the C interface of `embed_lib.cc`, i.e., without spawning a simulator or
+# copying data through FIFOs. Simulation memory is accessible in place as
+# numpy arrays. `__main__` shows a demonstrator which runs a binary up to the
+# end of its kernel.
+#
+# Only one simulation can exist per process. All calls have to come from the
+# same thread. `reset()` and `close()` end a simulation that is still running
+# as if the binary exited with code 1. `fesvr` does not free the stacks of its
+# contexts, so every simulation leaks them, whether it finished or not.
+
+import sys
+import ctypes
+import numpy as np
+
+# Reasons for `snitch_sim_run` to return
+RUN_CYCLES = 0
+RUN_STATUS = 1
+RUN_EXIT = 2
+
+
+class SnitchEmbed:
+
+    def __init__(self, lib: str, snitch_bin: str, args: list = []):
+        self.lib = ctypes.CDLL(lib)
+        self.snitch_bin = snitch_bin
+        self.args = list(args)
+        self.handle = None
+        c_void_p, c_uint64, c_int = ctypes.c_void_p, ctypes.c_uint64, ctypes.c_int
+        for name, restype, argtypes in [
+            ('create', c_void_p, [c_int, ctypes.POINTER(ctypes.c_char_p)]),
+            ('destroy', None, [c_void_p]),
+            ('run', c_int, [c_void_p, c_uint64, c_int]),
+            ('exit_code', c_int, [c_void_p]),
+            ('cycles', c_uint64, [c_void_p]),
+            ('status', c_int, [c_void_p]),
+            ('perf_counters', c_int, [c_void_p, ctypes.POINTER(c_uint64), c_int]),
+            ('symbol', c_uint64, [c_void_p, ctypes.c_char_p]),
+            ('view', c_void_p, [c_void_p, c_uint64, c_uint64]),
+            ('read', None, [c_void_p, c_uint64, c_uint64, c_void_p]),
+            ('write', None, [c_void_p, c_uint64, c_uint64, c_void_p]),
+        ]:
+            fn = getattr(self.lib, 'snitch_sim_' + name)
+            fn.restype = restype
+            fn.argtypes = argtypes
+        self.reset()
+
+    # Start over with a fresh model and a cleared memory. Views stay valid.
+    def reset(self):
+        self.close()
+        argv = [a.encode() for a in [self.snitch_bin] + self.args]
+        self.handle = self.lib.snitch_sim_create(
+            len(argv), (ctypes.c_char_p * len(argv))(*argv))
+        if not self.handle:
+            raise RuntimeError('Another simulation exists in this process')
+        self.finished = False
+
+    def close(self):
+        if self.handle:
+            self.lib.snitch_sim_destroy(self.handle)
+            self.handle = None
+
+    def __run(self, cycles: int, until_status: bool) -> int:
+        reason = self.lib.snitch_sim_run(self.handle, cycles, until_status)
+        self.finished = reason == RUN_EXIT
+        return reason
+
+    # Simulate `cycles` cycles. Returns whether the binary is still running.
+    def step(self, cycles: int = 1) -> bool:
+        return self.__run(cycles, False) != RUN_EXIT
+
+    # Simulate until SPATZ_STATUS becomes `status`, for at most `max_cycles`
+    # cycles. Returns whether the status was reached.
+    def run_until(self, status: int, max_cycles: int = 2**62) -> bool:
+        end = self.cycles + max_cycles
+        while self.status != status:
+            if self.finished or self.cycles >= end:
+                return False
+            self.__run(end - self.cycles, True)
+        return True
+
+    # Simulate until the binary exits and return its exit code.
+    def run(self) -> int:
+        while not self.finished:
+            self.__run(2**62, False)
+        return self.exit_code
+
+    @property
+    def exit_code(self) -> int:
+        return self.lib.snitch_sim_exit_code(self.handle)
+
+    @property
+    def cycles(self) -> int:
+        return self.lib.snitch_sim_cycles(self.handle)
+
+    # The current value of SPATZ_STATUS
+    @property
+    def status(self) -> int:
+        return self.lib.snitch_sim_status(self.handle)
+
+    # The performance counters of the cluster peripheral while the binary runs
+    def perf_counters(self) -> list:
+        buf = (ctypes.c_uint64 * 64)()
+        n = self.lib.snitch_sim_perf_counters(self.handle, buf, len(buf))
+        return list(buf[:n])
+
+    def symbol(self, name: str) -> int:
+        addr = self.lib.snitch_sim_symbol(self.handle, name.encode())
+        if not addr:
+            raise KeyError(f'No symbol `{name}` in `{self.snitch_bin}`')
+        return addr
+
+    # A numpy array aliasing the simulation memory at `addr`, e.g., to preload
+    # inputs or inspect outputs without copies. Writes through it are not
+    # visible to the HTIF `tohost` watch.
+    def view(self, addr: int, shape, dtype=np.uint8) -> np.ndarray:
+        dtype = np.dtype(dtype)
+        size = int(np.prod(shape)) * dtype.itemsize
+        ptr = self.lib.snitch_sim_view(self.handle, addr, size)
+        if not ptr:
+            raise ValueError(f'{size} bytes at 0x{addr:x} are not contiguous on the host')
+        buf = (ctypes.c_uint8 * size).from_address(ptr)
+        return np.frombuffer(buf, dtype).reshape(shape)
+
+    def read(self, addr: int, length: int) -> bytes:
+        buf = ctypes.create_string_buffer(length)
+        self.lib.snitch_sim_read(self.handle, addr, length, buf)
+        return buf.raw
+
+    def write(self, addr: int, data: bytes):
+        data = bytes(data)
+        self.lib.snitch_sim_write(self.handle, addr, len(data), data)
+
+
+if __name__ == "__main__":
+    sim = SnitchEmbed(*sys.argv[1:3], args=sys.argv[3:])
+    sim.run_until(1)
+    print(f'Kernel started at cycle {sim.cycles}')
+    sim.run_until(0)
+    print(f'Kernel finished at cycle {sim.cycles}, counters {sim.perf_counters()}')
+    print(f'Exit code {sim.run()} after {sim.cycles} cycles')
+    sim.close()
@@ -7,21 +7,41 @@
 #
 # This class implements a minimal wrapping IPC server for `tb_lib`.
 # `__main__` shows a demonstrator for it, running a simulation and accessing its memory.
+#
+# With `shm_size` set, the memory is accessed through a shared region instead
+# of the FIFOs: its data window appears in the simulation memory at `shm_base`
+# and is exposed as `window` without copies, e.g., for `numpy.frombuffer`.
 
 import os
 import sys
+import mmap
 import tempfile
 import subprocess
 import struct
 
+# Layout of the shared region, see `IpcIface` in `ipc.hh`
+SHM_MAGIC = 0x4d48535f43504953
+SHM_HEAD_OFFSET = 64
+SHM_TAIL_OFFSET = 128
+SHM_RING_OFFSET = 4096
+SHM_RING_ENTRIES = 64
+SHM_OP_SIZE = 64
+SHM_DATA_OFFSET = 8192
+
 
 class SnitchSim:
 
-    def __init__(self, sim_bin: str, snitch_bin: str):
+    def __init__(self, sim_bin: str, snitch_bin: str, shm_base: int = 0xF0000000,
+                 shm_size: int = 0, log: bool = False):
         self.sim_bin = sim_bin
         self.snitch_bin = snitch_bin
+        self.shm_base = shm_base
+        self.shm_size = shm_size
+        self.log = log
         self.sim = None
         self.tmpdir = None
+        self.shm = None
+        self.window = None
 
     def start(self):
         # Create FIFOs
@@ -30,12 +50,26 @@ class SnitchSim:
         os.mkfifo(tx_fd)
         rx_fd = os.path.join(self.tmpdir.name, 'rx')
         os.mkfifo(rx_fd)
+        # Create the shared region, preferably in memory
+        if self.shm_size:
+            shm_dir = '/dev/shm' if os.path.isdir('/dev/shm') else self.tmpdir.name
+            self.shm_file = tempfile.NamedTemporaryFile(dir=shm_dir, prefix='snitch-ipc-')
+            self.shm_file.truncate(SHM_DATA_OFFSET + self.shm_size)
+            self.shm = mmap.mmap(self.shm_file.fileno(), SHM_DATA_OFFSET + self.shm_size)
+            struct.pack_into('QQQ', self.shm, 0, SHM_MAGIC, self.shm_base, self.shm_size)
+            self.window = memoryview(self.shm)[SHM_DATA_OFFSET:]
+            self.head = 0
+            ipc_arg = f'--ipc-shm,{self.shm_file.name},{tx_fd},{rx_fd}'
+        else:
+            ipc_arg = f'--ipc,{tx_fd},{rx_fd}'
         # Start simulator process
-        ipc_arg = f'--ipc,{tx_fd},{rx_fd}'
-        self.sim = subprocess.Popen([self.sim_bin, self.snitch_bin, ipc_arg])
+        args = [self.sim_bin, self.snitch_bin, ipc_arg]
+        if self.log:
+            args.append('--ipc-log')
+        self.sim = subprocess.Popen(args)
         # Open FIFOs
-        self.tx = open(tx_fd, 'wb')
-        self.rx = open(rx_fd, 'rb')
+        self.tx = open(tx_fd, 'wb', buffering=0 if self.shm else -1)
+        self.rx = open(rx_fd, 'rb', buffering=0 if self.shm else -1)
 
     def __sim_active(func):
         def inner(self, *args, **kwargs):
@@ -45,8 +79,32 @@ class SnitchSim:
             return func(self, *args, **kwargs)
         return inner
 
+    # Enqueue a command into the ring of the shared region and wait for it
+    def __shm_op(self, opcode: int, addr: int, length: int, offset: int = 0) -> int:
+        op = SHM_RING_OFFSET + (self.head % SHM_RING_ENTRIES) * SHM_OP_SIZE
+        struct.pack_into('QQQQQ', self.shm, op, opcode, addr, length, offset, 0)
+        self.head += 1
+        struct.pack_into('Q', self.shm, SHM_HEAD_OFFSET, self.head)
+        self.tx.write(b'\0')
+        self.rx.read(1)
+        return struct.unpack_from('Q', self.shm, op + 32)[0]
+
+    def __in_window(self, addr: int, length: int) -> bool:
+        return self.shm_base <= addr and addr + length <= self.shm_base + self.shm_size
+
     @__sim_active
     def read(self, addr: int, length: int) -> bytes:
+        if self.shm:
+            if self.__in_window(addr, length):
+                off = addr - self.shm_base
+                return bytes(self.window[off:off + length])
+            data = bytearray(length)
+            view = memoryview(data)
+            for off in range(0, length, self.shm_size):
+                n = min(self.shm_size, length - off)
+                self.copy_out(addr + off, 0, n)
+                view[off:off + n] = self.window[:n]
+            return data
         op = struct.pack('QQQ', 0, addr, length)
         self.tx.write(op)
         self.tx.flush()
@@ -54,18 +112,43 @@ class SnitchSim:
 
     @__sim_active
     def write(self, addr: int, data: bytes):
+        if self.shm:
+            data = memoryview(data).cast('B')
+            if self.__in_window(addr, len(data)):
+                off = addr - self.shm_base
+                self.window[off:off + len(data)] = data
+                return
+            for off in range(0, len(data), self.shm_size):
+                n = min(self.shm_size, len(data) - off)
+                self.window[:n] = data[off:off + n]
+                self.copy_in(addr + off, 0, n)
+            return
         op = struct.pack('QQQ', 1, addr, len(data))
         self.tx.write(op)
         self.tx.write(data)
         self.tx.flush()
 
+    # Copy `length` bytes from `window[offset:]` to `addr` in the simulation
+    @__sim_active
+    def copy_in(self, addr: int, offset: int, length: int):
+        if self.__shm_op(1, addr, length, offset):
+            raise ValueError(f'Copy of {length} bytes at offset {offset} exceeds the window')
+
+    # Copy `length` bytes from `addr` in the simulation to `window[offset:]`
+    @__sim_active
+    def copy_out(self, addr: int, offset: int, length: int):
+        if self.__shm_op(0, addr, length, offset):
+            raise ValueError(f'Copy of {length} bytes at offset {offset} exceeds the window')
+
     @__sim_active
     def poll(self, addr: int, mask32: int, exp32: int):
+        if self.shm:
+            return self.__shm_op(2, addr, mask32 | exp32 << 32) & 0xFFFFFFFF
         # TODO: check endiannesses
         op = struct.pack('QQLL', 2, addr, mask32, exp32)
         self.tx.write(op)
         self.tx.flush()
-        return int.from_bytes(self.rx.read(4))
+        return int.from_bytes(self.rx.read(4), 'little')
 
     # Simulator can exit only once TX FIFO closes
     @__sim_active
@@ -76,6 +159,11 @@ class SnitchSim:
             self.sim.wait()
         else:
             self.sim.terminate()
+        if self.shm:
+            self.window.release()
+            self.shm.close()
+            self.shm_file.close()
+            self.shm = None
         self.tmpdir.cleanup()
         self.sim = None
 
@@ -2,7 +2,18 @@
 // Solderpad Hardware License, Version 0.51, see LICENSE for details.
 // SPDX-License-Identifier: SHL-0.51
 
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
 
 #include "sim.hh"
 #include "tb_lib.hh"
@@ -11,6 +22,135 @@ namespace sim {
 
 // The global memory all memory ports write into.
 GlobalMemory MEM;
+// The hart activity reported by the RTL.
+ActivityMonitor ACTIVITY;
+
+namespace {
+
+// The initial contents and load address of the symbol at `vaddr`.
+template <typename Phdr>
+SymbolData symbol_data(const uint8_t *buf, const Phdr *ph, unsigned phnum,
+                       const std::string &name, uint64_t vaddr,
+                       uint64_t size) {
+    for (unsigned i = 0; i < phnum; i++) {
+        if (ph[i].p_type != PT_LOAD || vaddr < ph[i].p_vaddr ||
+            vaddr + size > ph[i].p_vaddr + ph[i].p_memsz)
+            continue;
+        uint64_t offset = vaddr - ph[i].p_vaddr;
+        SymbolData data{name, ph[i].p_paddr + offset,
+                        std::vector<uint8_t>(size, 0)};
+        if (offset < ph[i].p_filesz)
+            memcpy(data.data.data(), buf + ph[i].p_offset + offset,
+                   std::min<uint64_t>(size, ph[i].p_filesz - offset));
+        return data;
+    }
+    throw std::runtime_error("symbol " + name +
+                             " is not in a loadable segment");
+}
+
+// FNV-1a over `len` bytes at `data`, continuing from `hash`.
+const uint64_t FNV1A_INIT = 0xcbf29ce484222325ull;
+uint64_t fnv1a(uint64_t hash, const void *data, size_t len) {
+    auto bytes = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < len; i++)
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    return hash;
+}
+
+// Load all `PT_LOAD` segments of the ELF image `buf` into the global memory
+// (unless `preloaded` is set) and return its symbol table. The function
+// symbols are additionally collected in `functions`, and the contents of the
+// symbols in `wanted` in `contents`. Unless it is null, `code_hash` receives a
+// hash of the entry point and the executable segments.
+template <typename Ehdr, typename Phdr, typename Shdr, typename Sym>
+std::map<std::string, uint64_t> load_elf_image(
+    const uint8_t *buf, size_t size, bool preloaded, reg_t *entry,
+    std::vector<FuncSymbol> *functions, const std::set<std::string> &wanted,
+    std::vector<SymbolData> *contents, uint64_t *code_hash) {
+    auto eh = reinterpret_cast<const Ehdr *>(buf);
+    if (sizeof(Ehdr) > size || eh->e_phoff + eh->e_phnum * sizeof(Phdr) > size ||
+        eh->e_shoff + eh->e_shnum * sizeof(Shdr) > size)
+        throw std::runtime_error("truncated ELF file");
+    *entry = eh->e_entry;
+    if (code_hash) *code_hash = fnv1a(FNV1A_INIT, entry, sizeof(*entry));
+
+    auto ph = reinterpret_cast<const Phdr *>(buf + eh->e_phoff);
+    for (unsigned i = 0; i < eh->e_phnum; i++) {
+        if (ph[i].p_type != PT_LOAD || ph[i].p_memsz == 0) continue;
+        if (ph[i].p_offset + ph[i].p_filesz > size)
+            throw std::runtime_error("truncated ELF segment");
+        if (code_hash && (ph[i].p_flags & PF_X)) {
+            uint64_t paddr = ph[i].p_paddr;
+            *code_hash = fnv1a(*code_hash, &paddr, sizeof(paddr));
+            *code_hash = fnv1a(*code_hash, buf + ph[i].p_offset,
+                               ph[i].p_filesz);
+        }
+        if (preloaded) continue;
+        MEM.write(ph[i].p_paddr, ph[i].p_filesz, buf + ph[i].p_offset,
+                  nullptr);
+        if (ph[i].p_memsz > ph[i].p_filesz) {
+            std::vector<uint8_t> zeros(ph[i].p_memsz - ph[i].p_filesz, 0);
+            MEM.write(ph[i].p_paddr + ph[i].p_filesz, zeros.size(),
+                      zeros.data(), nullptr);
+        }
+    }
+
+    std::map<std::string, uint64_t> symbols;
+    auto sh = reinterpret_cast<const Shdr *>(buf + eh->e_shoff);
+    for (unsigned i = 0; i < eh->e_shnum; i++) {
+        if (sh[i].sh_type != SHT_SYMTAB || sh[i].sh_link >= eh->e_shnum)
+            continue;
+        const Shdr &strtab = sh[sh[i].sh_link];
+        if (sh[i].sh_offset + sh[i].sh_size > size ||
+            strtab.sh_offset + strtab.sh_size > size)
+            throw std::runtime_error("truncated ELF symbol table");
+        auto sym = reinterpret_cast<const Sym *>(buf + sh[i].sh_offset);
+        auto str = reinterpret_cast<const char *>(buf + strtab.sh_offset);
+        for (size_t j = 0; j < sh[i].sh_size / sizeof(Sym); j++) {
+            if (sym[j].st_name >= strtab.sh_size) continue;
+            symbols[str + sym[j].st_name] = sym[j].st_value;
+            if (ELF32_ST_TYPE(sym[j].st_info) == STT_FUNC)
+                functions->push_back({sym[j].st_value, sym[j].st_size,
+                                      str + sym[j].st_name});
+            if (wanted.count(str + sym[j].st_name))
+                contents->push_back(symbol_data<Phdr>(
+                    buf, ph, eh->e_phnum, str + sym[j].st_name,
+                    sym[j].st_value, sym[j].st_size));
+        }
+    }
+    for (auto &name : wanted) {
+        if (!symbols.count(name))
+            throw std::runtime_error("no symbol " + name + " to restore");
+    }
+    return symbols;
+}
+
+}  // namespace
+
+void Sim::parse_tb_args(int argc, char **argv) {
+    for (auto i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--disable_preloading") == 0) {
+            printf("fesvr-based binary preloading disabled\n");
+            disable_preloading = true;
+        } else if (strncmp(argv[i], "--htif-interval=", 16) == 0) {
+            htif_interval = strtoull(argv[i] + 16, nullptr, 0);
+        } else if (strcmp(argv[i], "--idle-abort") == 0) {
+            idle_abort = true;
+        } else if (strncmp(argv[i], "--checkpoint=", 13) == 0) {
+            checkpoint_file = argv[i] + 13;
+        } else if (strncmp(argv[i], "--restore=", 10) == 0) {
+            restore_file = argv[i] + 10;
+        } else if (strncmp(argv[i], "--restore-symbols=", 18) == 0) {
+            std::istringstream names(argv[i] + 18);
+            for (std::string name; std::getline(names, name, ',');)
+                if (!name.empty()) restore_symbols.insert(name);
+        } else if (strncmp(argv[i], "--wave=", 7) == 0) {
+            wave_file = argv[i] + 7;
+        } else if (strcmp(argv[i], "+kernel_trace") == 0) {
+            kernel_trace = true;
+        }
+    }
+}
 
 // Override HTIF to populate bootloader with system specification and entry
 // symbol.
@@ -18,13 +158,70 @@ void Sim::start() {
     htif_t::start();
 }
 
+std::map<std::string, uint64_t> Sim::load_payload(const std::string &payload,
+                                                  reg_t *entry) {
+    int fd = open(payload.c_str(), O_RDONLY);
+    struct stat s;
+    if (fd < 0 || fstat(fd, &s) < 0)
+        throw std::runtime_error("could not open " + payload);
+    size_t size = s.st_size;
+    void *map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        throw std::runtime_error("could not map " + payload);
+    auto buf = static_cast<const uint8_t *>(map);
+
+    if (size < EI_NIDENT || memcmp(buf, ELFMAG, SELFMAG) != 0) {
+        munmap(map, size);
+        throw std::runtime_error(payload + " is not an ELF file");
+    }
+    // Hashing the binary takes longer than loading it, so only do so if a
+    // checkpoint is saved or restored.
+    bool hash = !checkpoint_file.empty() || !restore_file.empty();
+    if (hash) payload_hash = fnv1a(FNV1A_INIT, buf, size);
+
+    bool preloaded = is_address_preloaded(0, 0);
+    std::map<std::string, uint64_t> symbols;
+    std::vector<FuncSymbol> functions;
+    restore_data.clear();
+    try {
+        if (buf[EI_CLASS] == ELFCLASS32)
+            symbols = load_elf_image<Elf32_Ehdr, Elf32_Phdr, Elf32_Shdr,
+                                     Elf32_Sym>(buf, size, preloaded, entry,
+                                                &functions, restore_symbols,
+                                                &restore_data,
+                                                hash ? &code_hash : nullptr);
+        else if (buf[EI_CLASS] == ELFCLASS64)
+            symbols = load_elf_image<Elf64_Ehdr, Elf64_Phdr, Elf64_Shdr,
+                                     Elf64_Sym>(buf, size, preloaded, entry,
+                                                &functions, restore_symbols,
+                                                &restore_data,
+                                                hash ? &code_hash : nullptr);
+        else
+            throw std::runtime_error(payload + " has an unknown ELF class");
+    } catch (...) {
+        munmap(map, size);
+        throw;
+    }
+    munmap(map, size);
+    prof_set_functions(std::move(functions));
+
+    // Wake up `fesvr` whenever the target touches the HTIF registers.
+    MEM.watches.clear();
+    for (auto sym : {"tohost", "fromhost"}) {
+        auto it = symbols.find(sym);
+        if (it != symbols.end()) MEM.watches.push_back({it->second, 8});
+    }
+    this->symbols = symbols;
+    return symbols;
+}
+
 void Sim::read_chunk(addr_t taddr, size_t len, void *dst) {
     MEM.read(taddr, len, reinterpret_cast<uint8_t *>(dst));
 }
 
 void Sim::write_chunk(addr_t taddr, size_t len, const void *src) {
-    uint8_t strb[8] = {1, 1, 1, 1, 1, 1, 1, 1};
-    MEM.write(taddr, len, reinterpret_cast<const uint8_t *>(src), strb);
+    MEM.write(taddr, len, reinterpret_cast<const uint8_t *>(src), nullptr);
 }
 
 }  // namespace sim
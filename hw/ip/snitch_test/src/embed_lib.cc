@@ -0,0 +1,155 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Solderpad Hardware License, Version 0.51, see LICENSE for details.
+// SPDX-License-Identifier: SHL-0.51
+
+// C interface to embed the Verilator testbench into another process, e.g.,
+// Python through `SnitchEmbed.py`. The simulation runs in the calling thread:
+// `fesvr` and the model live in their own contexts, which hand control back
+// to the caller once the requested number of cycles has been simulated or
+// SPATZ_STATUS changes. As the testbench state is global, only one simulation
+// can exist at a time.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "sim.hh"
+#include "tb_lib.hh"
+
+namespace {
+
+struct Embedding {
+    std::vector<std::string> args;
+    std::vector<char *> argv;
+    std::unique_ptr<sim::Sim> sim;
+    context_t *caller;
+    context_t host;
+    bool started = false;
+    bool finished = false;
+    int exit_code = 0;
+};
+
+Embedding *active = nullptr;
+
+// Runs `fesvr` and the model until the binary exits.
+void host_main(void *arg) {
+    auto e = static_cast<Embedding *>(arg);
+    // Exceptions must not leave this context.
+    try {
+        e->exit_code = e->sim->run();
+    } catch (std::exception &ex) {
+        fprintf(stderr, "[TB] %s\n", ex.what());
+        e->exit_code = -1;
+    }
+    e->finished = true;
+    for (;;) e->caller->switch_to();
+}
+
+}  // namespace
+
+extern "C" {
+
+// Reasons for `snitch_sim_run` to return.
+enum { SNITCH_SIM_CYCLES = 0, SNITCH_SIM_PROBE = 1, SNITCH_SIM_EXIT = 2 };
+
+// Create a simulation of the binary `argv[0]`, followed by the testbench
+// arguments. Nothing is simulated before the first `snitch_sim_run`.
+void *snitch_sim_create(int argc, const char *const *argv) {
+    if (active) {
+        fprintf(stderr, "[TB] Only one simulation can exist at a time\n");
+        return nullptr;
+    }
+    auto e = new Embedding;
+    e->args.push_back("snitch_sim");
+    e->args.insert(e->args.end(), argv, argv + argc);
+    for (auto &a : e->args) e->argv.push_back(&a[0]);
+    e->argv.push_back(nullptr);
+    e->sim = std::make_unique<sim::Sim>(e->args.size(), e->argv.data());
+    active = e;
+    return e;
+}
+
+void snitch_sim_destroy(void *handle) {
+    auto e = static_cast<Embedding *>(handle);
+    if (!e) return;
+    // End an unfinished simulation through an HTIF exit request, as
+    // `--idle-abort` does, so `Sim::run` returns and the model is torn down
+    // before the `Sim` is deleted. Without a `tohost` symbol, its contexts are
+    // abandoned and the model is torn down by the next simulation.
+    if (e->started && !e->finished && e->sim->symbols.count("tohost")) {
+        e->sim->driver = nullptr;
+        e->sim->abort_requested = true;
+        e->caller = context_t::current();
+        e->sim->resume();
+    }
+    delete e;
+    active = nullptr;
+}
+
+// Simulate up to `cycles` cycles, or until SPATZ_STATUS changes if
+// `until_probe` is set. Returns why the simulation stopped.
+int snitch_sim_run(void *handle, uint64_t cycles, int until_probe) {
+    auto e = static_cast<Embedding *>(handle);
+    if (e->finished) return SNITCH_SIM_EXIT;
+    uint64_t time = sim::sim_time();
+    e->sim->driver = context_t::current();
+    e->sim->yield_time = time + 2 * cycles;
+    e->sim->yield_on_probe = until_probe;
+    e->caller = context_t::current();
+    if (!e->started) {
+        e->started = true;
+        e->host.init(host_main, e);
+        e->host.switch_to();
+    } else {
+        e->sim->resume();
+    }
+    if (e->finished) return SNITCH_SIM_EXIT;
+    return (uint64_t)sim::sim_time() < e->sim->yield_time ? SNITCH_SIM_PROBE
+                                                           : SNITCH_SIM_CYCLES;
+}
+
+// The exit code of a finished binary.
+int snitch_sim_exit_code(void *handle) {
+    return static_cast<Embedding *>(handle)->exit_code;
+}
+
+uint64_t snitch_sim_cycles(void *handle) { return sim::sim_time() / 2; }
+
+// The current value of SPATZ_STATUS.
+int snitch_sim_status(void *handle) { return sim::cluster_probe(); }
+
+// Copy up to `n` performance counters into `dst` and return their number.
+// The counters are gone once the binary has exited.
+int snitch_sim_perf_counters(void *handle, uint64_t *dst, int n) {
+    auto counters = sim::perf_counters();
+    n = std::min<int>(n, counters.size());
+    std::copy(counters.begin(), counters.begin() + n, dst);
+    return counters.size();
+}
+
+// Address of `symbol` in the loaded binary, or zero.
+uint64_t snitch_sim_symbol(void *handle, const char *symbol) {
+    auto &symbols = static_cast<Embedding *>(handle)->sim->symbols;
+    auto it = symbols.find(symbol);
+    return it == symbols.end() ? 0 : it->second;
+}
+
+// Host pointer through which `[addr, addr + len)` of the simulation memory can
+// be accessed in place, or `nullptr`. It stays valid across simulations.
+uint8_t *snitch_sim_view(void *handle, uint64_t addr, uint64_t len) {
+    return sim::MEM.view(addr, len);
+}
+
+void snitch_sim_read(void *handle, uint64_t addr, uint64_t len, uint8_t *dst) {
+    sim::MEM.read(addr, len, dst);
+}
+
+void snitch_sim_write(void *handle, uint64_t addr, uint64_t len,
+                      const uint8_t *src) {
+    sim::MEM.write(addr, len, src, nullptr);
+}
+}
@@ -6,12 +6,16 @@
 
 #pragma once
 
+#include <fcntl.h>
 #include <pthread.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <time.h>
+#include <unistd.h>
 
 #include <algorithm>
 #include <tb_lib.hh>
@@ -19,9 +23,8 @@
 class IpcIface {
    private:
     static const int IPC_BUF_SIZE = 4096;
-    static const int IPC_BUF_SIZE_STRB = IPC_BUF_SIZE / 8 + 1;
     static const int IPC_ERR_DOUBLE_ARG = 30;
-    static const long IPC_POLL_PERIOD_NS = 100000L;
+    static const int IPC_ERR_SHM = 31;
 
     // Possible IPC operations
     enum ipc_opcode_e {
@@ -37,10 +40,46 @@ class IpcIface {
         uint64_t len;
     } ipc_op_t;
 
+    // The shared-memory transport uses a region consisting of a header page,
+    // a page holding a ring of commands, and a data window which is mapped
+    // into the simulation memory. The client fills in the header, enqueues
+    // commands by bumping `head` and writing a byte into the doorbell FIFO;
+    // the simulator bumps `tail` and writes a byte into the completion FIFO
+    // for every completed command.
+    static const uint64_t IPC_SHM_MAGIC = 0x4d48535f43504953;  // "SIPC_SHM"
+    static const uint64_t IPC_SHM_RING_OFFSET = 4096;
+    static const uint64_t IPC_SHM_RING_ENTRIES = 64;
+    static const uint64_t IPC_SHM_DATA_OFFSET = 8192;
+
+    typedef struct {
+        uint64_t magic;
+        uint64_t base;  // target address of the data window
+        uint64_t size;  // size of the data window
+        uint64_t pad0[5];
+        uint64_t head;  // submitted commands, written by the client
+        uint64_t pad1[7];
+        uint64_t tail;  // completed commands, written by the simulator
+    } ipc_shm_hdr_t;
+
+    // `Read` copies from simulation memory into the data window at `offset`,
+    // `Write` the other way around. `result` is zero on success. `Poll` uses
+    // `len` like the FIFO transport and returns the read word in `result`.
+    typedef struct {
+        uint64_t opcode;
+        uint64_t addr;
+        uint64_t len;
+        uint64_t offset;
+        uint64_t result;
+        uint64_t pad[3];
+    } ipc_shm_op_t;
+
     // Args passed to IPC thread
     typedef struct {
         char* tx;
         char* rx;
+        char* shm;
+        uint8_t* region;
+        bool log;
     } ipc_targs_t;
 
     // Thread to asynchronously handle FIFOs
@@ -48,64 +87,65 @@ class IpcIface {
     pthread_t thread;
     bool active;
 
+    // Block until the 32b word at `addr` differs from `expected` in the bits
+    // of `mask`. Rather than periodically re-reading the word, wait for the
+    // target to write to it.
+    static uint32_t poll(uint64_t addr, uint32_t mask, uint32_t expected) {
+        uint32_t read;
+        sim::MEM.wait_write(addr, sizeof(uint32_t), [&] {
+            sim::MEM.read(addr, sizeof(uint32_t), (uint8_t*)(void*)&read);
+            return (read & mask) != (expected & mask);
+        });
+        return read;
+    }
+
     static void* ipc_thread_handle(void* in) {
         ipc_targs_t* targs = (ipc_targs_t*)in;
         // Open FIFOs
         FILE* tx = fopen(targs->tx, "rb");
         FILE* rx = fopen(targs->rx, "wb");
-        // Prepare data and full-strobe array
         uint8_t buf_data[IPC_BUF_SIZE];
-        uint8_t buf_strb[IPC_BUF_SIZE_STRB];
-        std::fill_n(buf_strb, IPC_BUF_SIZE_STRB, 0xFF);
         // Handle commands
         ipc_op_t op;
         while (fread(&op, sizeof(ipc_op_t), 1, tx)) {
             switch (op.opcode) {
                 case Read:
-                    // Read full blocks until one full block or less left
-                    printf("[IPC] Read from 0x%lx len %lu ...\n", op.addr,
-                           op.len);
-                    for (uint64_t i = op.len; i > IPC_BUF_SIZE;
-                         i -= IPC_BUF_SIZE) {
-                        sim::MEM.read(op.addr, IPC_BUF_SIZE, buf_data);
-                        fwrite(buf_data, IPC_BUF_SIZE, 1, rx);
+                    if (targs->log)
+                        printf("[IPC] Read from 0x%lx len %lu ...\n", op.addr,
+                               op.len);
+                    for (uint64_t i = 0; i < op.len; i += IPC_BUF_SIZE) {
+                        uint64_t n = std::min<uint64_t>(IPC_BUF_SIZE, op.len - i);
+                        sim::MEM.read(op.addr + i, n, buf_data);
+                        fwrite(buf_data, n, 1, rx);
                     }
-                    sim::MEM.read(op.addr, op.len, buf_data);
-                    fwrite(buf_data, op.len, 1, rx);
                     fflush(rx);
                     break;
                 case Write:
-                    // Write full blocks until one full block or less left
-                    printf("[IPC] Write to 0x%lx len %lu ...\n", op.addr, op.len);
-                    for (uint64_t i = op.len; i > IPC_BUF_SIZE;
-                         i -= IPC_BUF_SIZE) {
-                        fread(buf_data, IPC_BUF_SIZE, 1, tx);
-                        sim::MEM.write(op.addr, IPC_BUF_SIZE, buf_data,
-                                       buf_strb);
+                    if (targs->log)
+                        printf("[IPC] Write to 0x%lx len %lu ...\n", op.addr,
+                               op.len);
+                    for (uint64_t i = 0; i < op.len; i += IPC_BUF_SIZE) {
+                        uint64_t n = std::min<uint64_t>(IPC_BUF_SIZE, op.len - i);
+                        fread(buf_data, n, 1, tx);
+                        sim::MEM.write(op.addr + i, n, buf_data, nullptr);
                     }
-                    fread(buf_data, op.len, 1, tx);
-                    sim::MEM.write(op.addr, op.len, buf_data, buf_strb);
                     break;
                 case Poll:
                     // Unpack 32b checking mask and expected value from length
                     uint32_t mask = op.len & 0xFFFFFFFF;
                     uint32_t expected = (op.len >> 32) & 0xFFFFFFFF;
-                    printf("[IPC] Poll on 0x%lx mask 0x%x expected 0x%x ...\n",
-                           op.addr, mask, expected);
-                    uint32_t read;
-                    do {
-                        sim::MEM.read(op.addr, sizeof(uint32_t),
-                                      (uint8_t*)(void*)&read);
-                        nanosleep(
-                            (const struct timespec[]){{0, IPC_POLL_PERIOD_NS}},
-                            NULL);
-                    } while ((read & mask) == (expected & mask));
+                    if (targs->log)
+                        printf(
+                            "[IPC] Poll on 0x%lx mask 0x%x expected 0x%x "
+                            "...\n",
+                            op.addr, mask, expected);
+                    uint32_t read = poll(op.addr, mask, expected);
                     // Send back read 32b word
                     fwrite(&read, sizeof(uint32_t), 1, rx);
                     fflush(rx);
                     break;
             }
-            printf("[IPC] ... done\n");
+            if (targs->log) printf("[IPC] ... done\n");
         }
         // TX FIFO closed at other end: close both FIFOs and join main thread
         fclose(tx);
@@ -113,32 +153,128 @@ class IpcIface {
         pthread_exit(NULL);
     }
 
+    static void* ipc_shm_thread_handle(void* in) {
+        ipc_targs_t* targs = (ipc_targs_t*)in;
+        ipc_shm_hdr_t* hdr = (ipc_shm_hdr_t*)targs->region;
+        ipc_shm_op_t* ring =
+            (ipc_shm_op_t*)(targs->region + IPC_SHM_RING_OFFSET);
+        uint8_t* data = targs->region + IPC_SHM_DATA_OFFSET;
+        // Open FIFOs
+        int doorbell = open(targs->tx, O_RDONLY);
+        int completion = open(targs->rx, O_WRONLY);
+        // Handle commands
+        uint64_t tail = __atomic_load_n(&hdr->tail, __ATOMIC_RELAXED);
+        uint8_t token;
+        while (read(doorbell, &token, 1) == 1) {
+            uint64_t head = __atomic_load_n(&hdr->head, __ATOMIC_ACQUIRE);
+            for (; tail != head; tail++) {
+                ipc_shm_op_t* op = &ring[tail % IPC_SHM_RING_ENTRIES];
+                bool in_bounds = op->offset <= hdr->size &&
+                                 op->len <= hdr->size - op->offset;
+                switch (op->opcode) {
+                    case Read:
+                        if (targs->log)
+                            printf("[IPC] Read from 0x%lx len %lu\n", op->addr,
+                                   op->len);
+                        if (in_bounds)
+                            sim::MEM.read(op->addr, op->len, data + op->offset);
+                        op->result = !in_bounds;
+                        break;
+                    case Write:
+                        if (targs->log)
+                            printf("[IPC] Write to 0x%lx len %lu\n", op->addr,
+                                   op->len);
+                        if (in_bounds)
+                            sim::MEM.write(op->addr, op->len, data + op->offset,
+                                           nullptr);
+                        op->result = !in_bounds;
+                        break;
+                    case Poll:
+                        if (targs->log)
+                            printf("[IPC] Poll on 0x%lx\n", op->addr);
+                        op->result = poll(op->addr, op->len & 0xFFFFFFFF,
+                                          (op->len >> 32) & 0xFFFFFFFF);
+                        break;
+                }
+                __atomic_store_n(&hdr->tail, tail + 1, __ATOMIC_RELEASE);
+                if (write(completion, &token, 1) != 1) break;
+            }
+        }
+        // Doorbell closed at other end: close both FIFOs and join main thread
+        close(doorbell);
+        close(completion);
+        pthread_exit(NULL);
+    }
+
    public:
     // Conditionally construct IPC iff any arguments specify it
     IpcIface(int argc, char** argv) {
-        static constexpr char IPC_FLAG[6] = "--ipc";
+        static constexpr char IPC_FLAG[7] = "--ipc,";
+        static constexpr char IPC_SHM_FLAG[11] = "--ipc-shm,";
+        static constexpr char IPC_LOG_FLAG[10] = "--ipc-log";
         active = false;
+        targs.log = false;
         for (auto i = 1; i < argc; ++i) {
-            if (strncmp(argv[i], IPC_FLAG, strlen(IPC_FLAG)) == 0) {
-                // Check for duplicate args
-                if (active) {
-                    fprintf(stderr, "[IPC] Duplicate IPC thread args: %s",
-                            argv[i]);
-                    exit(IPC_ERR_DOUBLE_ARG);
-                }
-                // Parse IPC thread arguments
-                char* ipc_args = argv[i] + strlen(IPC_FLAG) + 1;
-                targs.tx = strtok(ipc_args, ",");
-                targs.rx = strtok(NULL, ",");
+            if (strcmp(argv[i], IPC_LOG_FLAG) == 0) targs.log = true;
+        }
+        for (auto i = 1; i < argc; ++i) {
+            bool fifo = strncmp(argv[i], IPC_FLAG, strlen(IPC_FLAG)) == 0;
+            bool shm = strncmp(argv[i], IPC_SHM_FLAG, strlen(IPC_SHM_FLAG)) == 0;
+            if (!fifo && !shm) continue;
+            // Check for duplicate args
+            if (active) {
+                fprintf(stderr, "[IPC] Duplicate IPC thread args: %s", argv[i]);
+                exit(IPC_ERR_DOUBLE_ARG);
+            }
+            // Parse IPC thread arguments
+            char* ipc_args = strchr(argv[i], ',') + 1;
+            targs.shm = shm ? strtok(ipc_args, ",") : NULL;
+            targs.tx = strtok(shm ? NULL : ipc_args, ",");
+            targs.rx = strtok(NULL, ",");
+            if (shm) {
+                // The data window has to be visible to the target before the
+                // simulation starts.
+                map_shm_window();
+                pthread_create(&thread, NULL, *ipc_shm_thread_handle,
+                               (void*)&targs);
+                printf(
+                    "[IPC] Thread launched with region `%s`, doorbell FIFO "
+                    "`%s`, completion FIFO `%s`\n",
+                    targs.shm, targs.tx, targs.rx);
+            } else {
                 // Initialize IO thread which will handle TX, RX pipes
                 pthread_create(&thread, NULL, *ipc_thread_handle,
                                (void*)&targs);
                 printf(
                     "[IPC] Thread launched with TX FIFO `%s`, RX FIFO `%s`\n",
                     targs.tx, targs.rx);
-                active = true;
             }
+            active = true;
+        }
+    }
+
+    // Map the region set up by the client and its data window into the
+    // simulation memory.
+    void map_shm_window() {
+        int fd = open(targs.shm, O_RDWR);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) < 0 ||
+            (uint64_t)st.st_size < IPC_SHM_DATA_OFFSET) {
+            fprintf(stderr, "[IPC] Could not open region `%s`\n", targs.shm);
+            exit(IPC_ERR_SHM);
+        }
+        void* region =
+            mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        ipc_shm_hdr_t* hdr = (ipc_shm_hdr_t*)region;
+        if (region == MAP_FAILED || hdr->magic != IPC_SHM_MAGIC ||
+            IPC_SHM_DATA_OFFSET + hdr->size > (uint64_t)st.st_size) {
+            fprintf(stderr, "[IPC] Invalid region `%s`\n", targs.shm);
+            exit(IPC_ERR_SHM);
         }
+        targs.region = (uint8_t*)region;
+        sim::MEM.mappings.push_back(
+            {hdr->base, hdr->size, targs.region + IPC_SHM_DATA_OFFSET});
     }
 
     // Conditionally destroy IPC iff it is enabled
@@ -0,0 +1,146 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Solderpad Hardware License, Version 0.51, see LICENSE for details.
+// SPDX-License-Identifier: SHL-0.51
+
+// Statistical PC sampling, enabled with `+pc_sample=<cycles>`. Every <cycles>
+// cycles, `spatz_cc.sv` reports the PC of each hart, whether it sleeps in WFI
+// and whether its Spatz holds a vector instruction. The calls and returns
+// retired by the harts maintain a shadow stack of return addresses per hart,
+// which provides the callers of a sample.
+//
+// At the end of the simulation, the samples are symbolized against the
+// function symbols of the binary and written as folded stacks, one line per
+// unique stack:
+//   hart_<id>;<caller>;...;<function>[;[spatz]|;[wfi]] <samples>
+// which e.g. `flamegraph.pl` turns into a flame graph.
+
+#include <svdpi.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "sim.hh"
+
+/// DPI Functions.
+extern "C" {
+void tb_prof_open(int hart_id, const char *path);
+void tb_prof_sample(int hart_id, int pc, svBit wfi, svBit spatz_busy);
+void tb_prof_call(int hart_id, int ret_addr);
+void tb_prof_ret(int hart_id, int target);
+void tb_prof_close(int hart_id);
+}
+
+namespace {
+
+// Maximum depth of a shadow stack. Deeper calls are not recorded.
+const size_t MAX_DEPTH = 64;
+
+// States of a hart a sample is additionally attributed to.
+enum State : uint32_t { STATE_NONE, STATE_SPATZ, STATE_WFI };
+
+struct Hart {
+    // Return addresses of the calls in flight, innermost last.
+    std::vector<uint32_t> stack;
+    // Number of samples per stack, which holds the return addresses, the PC
+    // and the state of the hart.
+    std::map<std::vector<uint32_t>, uint64_t> samples;
+};
+
+std::map<int, Hart> harts;
+std::set<int> open_harts;
+std::string out_path;
+std::vector<sim::FuncSymbol> functions;
+
+// Name of the function containing `addr`.
+std::string symbolize(uint32_t addr) {
+    auto it = std::upper_bound(
+        functions.begin(), functions.end(), addr,
+        [](uint64_t a, const sim::FuncSymbol &f) { return a < f.addr; });
+    if (it != functions.begin()) {
+        --it;
+        if (addr < it->addr + std::max<uint64_t>(it->size, 1)) return it->name;
+    }
+    char buf[16];
+    snprintf(buf, sizeof(buf), "0x%08x", addr);
+    return buf;
+}
+
+void write_folded() {
+    std::map<std::string, uint64_t> folded;
+    uint64_t total = 0;
+    for (auto &h : harts) {
+        for (auto &s : h.second.samples) {
+            const auto &key = s.first;
+            std::string stack = "hart_" + std::to_string(h.first);
+            // A return address points behind the call of its caller.
+            for (size_t i = 0; i + 2 < key.size(); i++)
+                stack += ";" + symbolize(key[i] - 4);
+            stack += ";" + symbolize(key[key.size() - 2]);
+            if (key.back() == STATE_SPATZ) stack += ";[spatz]";
+            if (key.back() == STATE_WFI) stack += ";[wfi]";
+            folded[stack] += s.second;
+            total += s.second;
+        }
+    }
+
+    FILE *f = fopen(out_path.c_str(), "w");
+    if (!f) {
+        fprintf(stderr, "[Profiler] Could not open %s\n", out_path.c_str());
+        return;
+    }
+    for (auto &s : folded)
+        fprintf(f, "%s %llu\n", s.first.c_str(), (unsigned long long)s.second);
+    fclose(f);
+    fprintf(stderr, "[Profiler] Wrote %llu samples to %s\n",
+            (unsigned long long)total, out_path.c_str());
+}
+
+}  // namespace
+
+namespace sim {
+void prof_set_functions(std::vector<FuncSymbol> funcs) {
+    std::sort(funcs.begin(), funcs.end(),
+              [](const FuncSymbol &a, const FuncSymbol &b) {
+                  return a.addr < b.addr;
+              });
+    functions = std::move(funcs);
+}
+}  // namespace sim
+
+void tb_prof_open(int hart_id, const char *path) {
+    harts[hart_id] = Hart();
+    open_harts.insert(hart_id);
+    out_path = path;
+}
+
+void tb_prof_sample(int hart_id, int pc, svBit wfi, svBit spatz_busy) {
+    auto &hart = harts[hart_id];
+    std::vector<uint32_t> key(hart.stack);
+    key.push_back(pc);
+    key.push_back(wfi ? STATE_WFI : spatz_busy ? STATE_SPATZ : STATE_NONE);
+    hart.samples[key]++;
+}
+
+void tb_prof_call(int hart_id, int ret_addr) {
+    auto &stack = harts[hart_id].stack;
+    if (stack.size() < MAX_DEPTH) stack.push_back(ret_addr);
+}
+
+void tb_prof_ret(int hart_id, int target) {
+    // Unwind to the frame returned to, which also drops the frames of calls
+    // that never returned, e.g., due to a `longjmp`.
+    auto &stack = harts[hart_id].stack;
+    auto it = std::find(stack.rbegin(), stack.rend(), (uint32_t)target);
+    if (it != stack.rend()) stack.erase(std::prev(it.base()), stack.end());
+}
+
+void tb_prof_close(int hart_id) {
+    if (!open_harts.erase(hart_id) || !open_harts.empty()) return;
+    write_folded();
+    harts.clear();
+}
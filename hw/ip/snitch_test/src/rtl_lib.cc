@@ -19,18 +19,17 @@ int get_entry_point();
 void tb_memory_read(long long addr, int len, const svOpenArrayHandle data);
 void tb_memory_write(long long addr, int len, const svOpenArrayHandle data,
                      const svOpenArrayHandle strb);
+void tb_hart_status(int hart_id, svBit wfi, svBit dma_busy);
+void tb_boot_done();
+void tb_cluster_probe(svBit probe);
+svBit tb_kernel_window();
 }
 
 namespace sim {
 void sim_thread_main(void *arg) { ((Sim *)arg)->main(); }
 
 Sim::Sim(int argc, char **argv) : htif_t(argc, argv) {
-    for (auto i = 1; i < argc; ++i) {
-        if (strcmp(argv[i], "--disable_preloading") == 0) {
-            printf("fesvr-based binary preloading disabled\n");
-            disable_preloading = true;
-        }
-    }
+    parse_tb_args(argc, argv);
     host = context_t::current();
     target.init(sim_thread_main, this);
     target.switch_to();
@@ -58,6 +57,12 @@ void Sim::main() {
 
 std::unique_ptr<sim::Sim> s;
 
+// Number of ticks between HTIF checks if the binary has no `tohost` symbol to
+// watch.
+const int HTIFTickInterval = 100;
+// Ticks since `fesvr` was last entered.
+static uint64_t htif_ticks = 0;
+
 int fesvr_tick() {
     // Initialize on first tick.
     if (s == nullptr) {
@@ -103,7 +108,26 @@ int fesvr_tick() {
 
         s = std::make_unique<sim::Sim>(argc, (char **)argv);
     }
-    return s->run();
+
+    // Once the cluster is idle for good, give `fesvr` a last chance to pick up
+    // an exit request and otherwise end the simulation.
+    if (s->idle_abort && sim::ACTIVITY.idle()) {
+        int ret = s->run();
+        if (ret & 1) return ret;
+        fprintf(stderr, "[TB] All harts are idle without a wake-up source\n");
+        return (1 << 1) | 1;
+    }
+
+    // Only switch to `fesvr` on HTIF traffic and, optionally, in regular
+    // intervals. Fall back to polling if there is no `tohost` to watch.
+    uint64_t interval = s->htif_interval;
+    if (!interval && sim::MEM.watches.empty()) interval = HTIFTickInterval;
+    htif_ticks++;
+    if (!sim::MEM.watch_hit && !(interval && htif_ticks >= interval)) return 0;
+    htif_ticks = 0;
+    int ret = s->run();
+    sim::MEM.watch_hit = false;
+    return ret;
 }
 
 // DPI calls.
@@ -115,6 +139,20 @@ void tb_memory_read(long long addr, int len, const svOpenArrayHandle data) {
     sim::MEM.read(addr, len, (uint8_t *)data_ptr);
 }
 
+void tb_hart_status(int hart_id, svBit wfi, svBit dma_busy) {
+    sim::ACTIVITY.update(hart_id, wfi, dma_busy);
+}
+
+void tb_boot_done() { sim::ACTIVITY.boot_done = true; }
+
+// Checkpoints are only supported by the Verilator testbench, only keep track
+// of the kernel window.
+static bool kernel_window = false;
+
+void tb_cluster_probe(svBit probe) { kernel_window = probe; }
+
+svBit tb_kernel_window() { return kernel_window; }
+
 void tb_memory_write(long long addr, int len, const svOpenArrayHandle data,
                      const svOpenArrayHandle strb) {
     // std::cout << "[TB] Write " << std::hex << addr << std::dec << " (" << len
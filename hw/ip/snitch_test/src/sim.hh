@@ -9,14 +9,23 @@
 #include <chrono>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <set>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
 namespace sim {
 using namespace std::chrono_literals;
 
+// The initial contents of a symbol of the binary, see `restore_symbols`.
+struct SymbolData {
+    std::string name;
+    uint64_t addr;
+    std::vector<uint8_t> data;
+};
+
 // Simulation object with `fesvr` support.
 struct Sim : htif_t {
     Sim(int argc, char **argv);
@@ -26,31 +35,99 @@ struct Sim : htif_t {
     int run();
     void main();
 
+    // Parse the testbench arguments following the binary.
+    void parse_tb_args(int argc, char **argv);
+
     // HTIF overrides. Calls into the global memory.
     void read_chunk(addr_t taddr, size_t len, void *dst);
     void write_chunk(addr_t taddr, size_t len, const void *src);
     bool is_address_preloaded(addr_t taddr, size_t len) override {
         return disable_preloading;
     }
+    // Copy the `PT_LOAD` segments of the binary directly into the global
+    // memory instead of going through `fesvr`'s chunked memory interface.
+    std::map<std::string, uint64_t> load_payload(const std::string &payload,
+                                                 reg_t *entry) override;
 
     void idle();
+    // End the simulation as if the target exited with code 1.
+    void abort_run();
 
     // Force alignment to 8 byte.
     size_t chunk_align() { return 8; }
-    // Force chunk size to 8 byte.
-    size_t chunk_max_size() { return 8; }
+    // The global memory takes arbitrarily large chunks.
+    size_t chunk_max_size() { return 1 << 20; }
 
     void reset() {}
 
     int entry_point() { return get_entry_point(); }
 
+    // Cycles between unconditional HTIF checks. If zero, `fesvr` is only
+    // entered when the target writes `tohost` or `fromhost`.
+    uint64_t htif_interval = 0;
+    // Abort the simulation once the cluster is idle for good, see
+    // `ActivityMonitor::idle`.
+    bool idle_abort = false;
+    // Save a checkpoint into this file when the kernel window opens, i.e.,
+    // on the first write of 1 to SPATZ_STATUS.
+    std::string checkpoint_file;
+    // Resume the simulation from this checkpoint.
+    std::string restore_file;
+    // Symbols whose contents are loaded from the binary after a restore, and
+    // these contents. With them, the checkpoint may have been taken with a
+    // binary that differs in its data, e.g., the parameters or inputs of a
+    // kernel; only its code has to match.
+    std::set<std::string> restore_symbols;
+    std::vector<SymbolData> restore_data;
+    // Dump a waveform into this file, see `VLT_TRACE`.
+    std::string wave_file;
+    // Only dump the waveform and the instruction traces while SPATZ_STATUS is
+    // set, i.e., in the kernel window. Set by the `+kernel_trace` plusarg.
+    bool kernel_trace = false;
+    // Hash of the binary, which a checkpoint has to be resumed with. Only
+    // computed with `--checkpoint` or `--restore`, as is `code_hash`.
+    uint64_t payload_hash = 0;
+    // Hash of the code of the binary, i.e., of its entry point and executable
+    // segments, see `restore_symbols`.
+    uint64_t code_hash = 0;
+    // Cycles simulated by `run`.
+    uint64_t cycles = 0;
+    // Symbols of the binary.
+    std::map<std::string, uint64_t> symbols;
+
+    // If set, the target switches to the `driver` context once `TIME`
+    // reaches `yield_time` or, with `yield_on_probe`, once SPATZ_STATUS
+    // changes. `resume` continues the simulation from there. Used to embed
+    // the simulation, see `embed_lib.cc`.
+    context_t *driver = nullptr;
+    uint64_t yield_time = 0;
+    bool yield_on_probe = false;
+    void resume() { target.switch_to(); }
+    // End a yielded simulation through `abort_run` once it is resumed, so
+    // `run` returns and the model is torn down.
+    bool abort_requested = false;
+
    private:
     context_t *host;
     context_t target;
-    bool vlt_vcd = false;
     bool disable_preloading = false;
 };
 
 void sim_thread_main(void *arg);
 
+// A function symbol of the binary.
+struct FuncSymbol {
+    uint64_t addr;
+    uint64_t size;
+    std::string name;
+};
+
+// Symbolize the PC samples against these functions, see `prof_lib.cc`.
+void prof_set_functions(std::vector<FuncSymbol> functions);
+
+// Queries of the verilated model.
+int sim_time();
+bool cluster_probe();
+std::vector<uint64_t> perf_counters();
+
 }  // namespace sim
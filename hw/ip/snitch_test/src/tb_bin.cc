@@ -4,20 +4,108 @@
 
 #include <printf.h>
 
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
 #include "ipc.hh"
 #include "sim.hh"
 
-int main(int argc, char **argv, char **env) {
-    // Write binary path to logs/binary for the `make annotate` target
+// Write binary path to logs/binary for the `make annotate` target
+static void write_rtlbinary(const char *binary) {
     FILE *fd;
     fd = fopen("logs/.rtlbinary", "w");
-    if (fd != NULL && argc >= 2) {
-        fprintf(fd, "%s\n", argv[1]);
+    if (fd != NULL) {
+        fprintf(fd, "%s\n", binary);
         fclose(fd);
     } else {
         fprintf(stderr,
                 "Warning: Failed to write binary name to logs/.rtlbinary\n");
     }
+}
+
+// Simulate the binaries listed in `list` one after the other in this process.
+// Every line holds a binary followed by its arguments; empty lines and lines
+// starting with `#` are skipped. The arguments in `extra` are passed to all
+// binaries. A binary that cannot be loaded counts as failed and the batch
+// continues with the next one. The exit code of each binary is appended to
+// `<list>.results` as soon as it finished, one `<exit code> <binary>` line
+// per binary, from which the CMake test macros derive one test per binary.
+// Returns non-zero if any of the binaries failed.
+static int run_batch(const char *argv0, const char *list,
+                     const std::vector<std::string> &extra) {
+    std::ifstream file(list);
+    if (!file) {
+        fprintf(stderr, "[TB] Could not open batch list %s\n", list);
+        return 1;
+    }
+    std::string results_path = std::string(list) + ".results";
+    FILE *results_file = fopen(results_path.c_str(), "w");
+    if (!results_file) {
+        fprintf(stderr, "[TB] Could not open batch results %s\n",
+                results_path.c_str());
+        return 1;
+    }
+
+    struct Result {
+        std::string binary;
+        int exit_code;
+        uint64_t cycles;
+    };
+    std::vector<Result> results;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream words(line);
+        std::vector<std::string> args{argv0};
+        for (std::string w; words >> w;) args.push_back(w);
+        if (args.size() < 2 || args[1][0] == '#') continue;
+        args.insert(args.end(), extra.begin(), extra.end());
+
+        std::vector<char *> sim_argv;
+        for (auto &a : args) sim_argv.push_back(&a[0]);
+        sim_argv.push_back(nullptr);
+
+        fprintf(stderr, "[TB] Running %s\n", args[1].c_str());
+        write_rtlbinary(args[1].c_str());
+        int exit_code;
+        uint64_t cycles = 0;
+        try {
+            auto sim =
+                std::make_unique<sim::Sim>(args.size(), sim_argv.data());
+            exit_code = sim->run();
+            cycles = sim->cycles;
+        } catch (const std::exception &e) {
+            fprintf(stderr, "[TB] %s failed: %s\n", args[1].c_str(),
+                    e.what());
+            exit_code = -1;
+        }
+        results.push_back({args[1], exit_code, cycles});
+        fprintf(results_file, "%d %s\n", exit_code, args[1].c_str());
+        fflush(results_file);
+    }
+    fclose(results_file);
+
+    int failed = 0;
+    fprintf(stderr, "[TB] Batch summary:\n");
+    for (auto &r : results) {
+        fprintf(stderr, "[TB] %s %10llu cycles  exit code %3d  %s\n",
+                r.exit_code ? "FAIL" : "PASS", (unsigned long long)r.cycles,
+                r.exit_code, r.binary.c_str());
+        failed += r.exit_code != 0;
+    }
+    fprintf(stderr, "[TB] %d of %zu binaries passed\n",
+            (int)results.size() - failed, results.size());
+    return failed != 0;
+}
+
+int main(int argc, char **argv, char **env) {
+    // Batch mode: `--batch <list> [args...]`.
+    if (argc >= 3 && strcmp(argv[1], "--batch") == 0) {
+        return run_batch(argv[0], argv[2],
+                         std::vector<std::string>(argv + 3, argv + argc));
+    }
+
+    if (argc >= 2) write_rtlbinary(argv[1]);
 
     // Initialize IPC bridge if specified
     IpcIface ipc_iface(argc, argv);
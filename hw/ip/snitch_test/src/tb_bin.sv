@@ -36,7 +36,7 @@ module tb_bin;
     end
   end
 
-  // Start `fesvr`.
+  // Start `fesvr`. It is ticked every cycle, but only entered on HTIF traffic.
   initial begin
     automatic int exit_code;
 
@@ -44,7 +44,7 @@ module tb_bin;
       exit_code = fesvr_tick();
 
       if (exit_code == 0)
-        #200ns;
+        @(posedge clk_i);
     end while (exit_code == 0);
     exit_code >>= 1;
     if (exit_code > 0) begin
@@ -6,16 +6,40 @@
 // Author: Florian Zaruba <zarubaf@iis.ee.ethz.ch>
 
 #pragma once
-#include "sim.hh"
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace sim {
 
+// The simulation memory. The lower 4 GiB of the address space are backed by a
+// single reserved `mmap` region whose pages are only committed by the host
+// kernel once they are written. Addresses above fall back to a sparse map of
+// 4 KiB pages.
 struct GlobalMemory {
     static constexpr size_t ADDR_SHIFT = 12;
     static constexpr size_t PAGE_SIZE = (size_t)1 << ADDR_SHIFT;
+    static constexpr size_t FLAT_SHIFT = 32;
+    static constexpr uint64_t FLAT_SIZE = (uint64_t)1 << FLAT_SHIFT;
+    static constexpr size_t FLAT_PAGES = FLAT_SIZE >> ADDR_SHIFT;
 
+    // Flat backing store for `[0, FLAT_SIZE)`, or `nullptr` if the host could
+    // not reserve it.
+    uint8_t *flat = nullptr;
+    // Pages outside of the flat region.
     std::unordered_map<uint64_t, std::unique_ptr<uint8_t[]>> pages;
-    std::set<uint64_t> touched;
+    // One bit per flat page that has been written. Atomic, since IPC threads
+    // write to the memory concurrently with the simulation.
+    std::vector<std::atomic<uint64_t>> touched;
 
     // A mapping of host memory into Manticore memory.
     struct Mapping {
@@ -25,6 +49,36 @@ struct GlobalMemory {
     };
     std::vector<Mapping> mappings;
 
+    // Address ranges whose writes raise `watch_hit`. Used to enter `fesvr`
+    // only on HTIF traffic instead of polling it.
+    struct Watch {
+        uint64_t base;
+        size_t size;
+    };
+    std::vector<Watch> watches;
+    std::atomic<bool> watch_hit{false};
+
+    // Writes to `[notify_base, notify_base + notify_size)` wake up the thread
+    // blocked in `wait_write`, e.g., to poll memory from an IPC thread.
+    std::atomic<bool> notify_active{false};
+    uint64_t notify_base = 0;
+    size_t notify_size = 0;
+    std::mutex notify_mutex;
+    std::condition_variable notify_cv;
+
+    GlobalMemory() : touched(FLAT_PAGES / 64) {
+        void *p = mmap(nullptr, FLAT_SIZE, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (p != MAP_FAILED) flat = static_cast<uint8_t *>(p);
+    }
+
+    ~GlobalMemory() {
+        if (flat) munmap(flat, FLAT_SIZE);
+    }
+
+    GlobalMemory(const GlobalMemory &) = delete;
+    GlobalMemory &operator=(const GlobalMemory &) = delete;
+
     uint8_t *find_mapping(uint64_t addr) const {
         for (const auto &m : mappings) {
             if (m.base <= addr && m.base + m.size > addr) {
@@ -34,87 +88,262 @@ struct GlobalMemory {
         return nullptr;
     }
 
-    // Copy a chunk of data into memory.
-    void write(size_t addr, size_t len, const uint8_t *data,
-               const uint8_t *strb) {
-        // std::cout << "[GlobalMemory] Write " << std::hex << addr << std::dec
-        //           << " (" << len << " bytes)\n";
-        size_t end = addr + len;
-        size_t data_idx = 0;
-        while (addr < end) {
-            size_t byte_start = addr;
-            addr >>= ADDR_SHIFT;
-            auto &page = pages[addr];
-            uint64_t page_idx = addr;
-            if (!page) {
-                // std::cout << "[TB] Allocate page " << std::hex << (addr <<
-                // ADDR_SHIFT) << "\n";
-                page = std::make_unique<uint8_t[]>(PAGE_SIZE);
-                std::fill(&page[0], &page[PAGE_SIZE], 0);
+    // Drop all contents, i.e., zero the whole memory.
+    void clear() {
+        if (flat) {
+            // Return runs of touched pages to the host kernel.
+            for (uint64_t p = 0; p < FLAT_PAGES;) {
+                if (!is_touched(p)) {
+                    p = touched[p / 64].load(std::memory_order_relaxed)
+                            ? p + 1
+                            : (p / 64 + 1) * 64;
+                    continue;
+                }
+                uint64_t first = p;
+                while (p < FLAT_PAGES && is_touched(p)) p++;
+                madvise(flat + (first << ADDR_SHIFT), (p - first) << ADDR_SHIFT,
+                        MADV_DONTNEED);
             }
-            // std::cout << "[TB] Write to page " << std::hex << (addr <<
-            // ADDR_SHIFT)
-            // << "\n";
-            addr += 1;
-            addr <<= ADDR_SHIFT;
-            size_t byte_end = std::min(addr, end);
-            bool any_changed = false;
-            for (size_t i = byte_start; i < byte_end; i++, data_idx++) {
-                if (!strb || strb[data_idx]) {
-                    // std::cout << "[TB] Write byte " << std::hex << i << " = "
-                    // << (uint32_t)data[data_idx] << "\n";
-                    auto host = find_mapping(i);
-                    if (host) {
-                        *host = data[data_idx];
-                    } else {
-                        page[i % PAGE_SIZE] = data[data_idx];
-                        any_changed = true;
-                    }
+        }
+        for (auto &w : touched) w.store(0, std::memory_order_relaxed);
+        pages.clear();
+    }
+
+    // Call `f(page_idx, data)` for every page that has been written.
+    template <typename F>
+    void for_each_page(F f) const {
+        if (flat) {
+            for (size_t i = 0; i < touched.size(); i++) {
+                uint64_t w = touched[i].load(std::memory_order_relaxed);
+                for (; w; w &= w - 1) {
+                    uint64_t p = i * 64 + __builtin_ctzll(w);
+                    f(p, flat + (p << ADDR_SHIFT));
                 }
             }
-            if (any_changed) touched.insert(page_idx);
         }
-        std::cout << std::dec;
+        for (const auto &page : pages) f(page.first, page.second.get());
+    }
+
+    // Serialize all written pages into `os`, which has to provide a
+    // `write(const void *, size_t)` method.
+    template <typename Os>
+    void save(Os &os) const {
+        uint64_t count = 0;
+        for_each_page([&](uint64_t, const uint8_t *) { count++; });
+        os.write(&count, sizeof(count));
+        for_each_page([&](uint64_t idx, const uint8_t *data) {
+            os.write(&idx, sizeof(idx));
+            os.write(data, PAGE_SIZE);
+        });
+    }
+
+    // Replace the contents with the pages serialized by `save`. `is` has to
+    // provide a `read(void *, size_t)` method.
+    template <typename Is>
+    void restore(Is &is) {
+        clear();
+        uint64_t count;
+        is.read(&count, sizeof(count));
+        while (count--) {
+            uint64_t idx;
+            size_t n;
+            is.read(&idx, sizeof(idx));
+            is.read(backing(idx << ADDR_SHIFT, PAGE_SIZE, n, true), PAGE_SIZE);
+        }
+    }
+
+    // Copy a chunk of data into memory.
+    void write(size_t addr, size_t len, const uint8_t *data,
+               const uint8_t *strb) {
+        if (!watches.empty()) check_watches(addr, len);
+        for (size_t i = 0; i < len;) {
+            size_t n;
+            uint8_t *dst = resolve(addr + i, len - i, n, true);
+            copy_strb(dst, data + i, strb ? strb + i : nullptr, n);
+            i += n;
+        }
+        if (notify_active) notify(addr, len);
     }
 
     // Copy a chunk of data out of the memory.
     void read(size_t addr, size_t len, uint8_t *data) {
-        // std::cout << "[GlobalMemory] Read " << std::hex << addr << std::dec
-        //           << " (" << len << " bytes)\n";
-        size_t end = addr + len;
-        size_t data_idx = 0;
-        while (addr < end) {
-            size_t byte_start = addr;
-            addr >>= ADDR_SHIFT;
-            auto &page = pages[addr];
-            // std::cout << "[TB] Read from page " << std::hex << (addr <<
-            // ADDR_SHIFT)
-            // << "\n";
-            addr += 1;
-            addr <<= ADDR_SHIFT;
-            size_t byte_end = std::min(addr, end);
-            for (size_t i = byte_start; i < byte_end; i++, data_idx++) {
-                auto host = find_mapping(i);
-                if (host) {
-                    data[data_idx] = *host;
-                } else {
-                    if (page) {
-                        // std::cout << "[TB] Read byte " << std::hex << i <<
-                        // "\n";
-                        data[data_idx] = page[i % PAGE_SIZE];
-                    } else {
-                        data[data_idx] = 0;
-                    }
-                }
+        while (len > 0) {
+            size_t n;
+            const uint8_t *src = resolve(addr, len, n, false);
+            if (src)
+                std::memcpy(data, src, n);
+            else
+                std::memset(data, 0, n);
+            addr += n;
+            len -= n;
+            data += n;
+        }
+    }
+
+    // Return a host pointer through which `[addr, addr + len)` can be
+    // accessed in place, or `nullptr` if the range is not contiguous on the
+    // host. Its pages count as written. Writes through the pointer neither
+    // raise `watch_hit` nor wake up `wait_write`.
+    uint8_t *view(uint64_t addr, size_t len) {
+        if (len == 0) return nullptr;
+        size_t n;
+        uint8_t *ptr = resolve(addr, len, n, true);
+        return n == len ? ptr : nullptr;
+    }
+
+    // Block until `done()` holds, re-evaluating it whenever the target writes
+    // to `[base, base + size)`. Only one thread may wait at a time.
+    template <typename F>
+    void wait_write(uint64_t base, size_t size, F done) {
+        std::unique_lock<std::mutex> lock(notify_mutex);
+        notify_base = base;
+        notify_size = size;
+        notify_active = true;
+        // The timeout covers writes which raced with raising `notify_active`.
+        while (!done()) notify_cv.wait_for(lock, std::chrono::milliseconds(10));
+        notify_active = false;
+    }
+
+   private:
+    void notify(uint64_t addr, size_t len) {
+        std::lock_guard<std::mutex> lock(notify_mutex);
+        if (notify_base < addr + len && notify_base + notify_size > addr)
+            notify_cv.notify_one();
+    }
+
+    void check_watches(uint64_t addr, size_t len) {
+        for (const auto &w : watches) {
+            if (w.base < addr + len && w.base + w.size > addr) {
+                watch_hit = true;
+                return;
+            }
+        }
+    }
+
+    // Like `backing`, but honors the host mappings.
+    uint8_t *resolve(uint64_t addr, size_t len, size_t &n, bool alloc) {
+        for (const auto &m : mappings) {
+            if (m.base <= addr && m.base + m.size > addr) {
+                n = std::min<uint64_t>(len, m.base + m.size - addr);
+                return m.into + (addr - m.base);
+            }
+            // Stop in front of the next mapping.
+            if (m.base > addr) len = std::min<uint64_t>(len, m.base - addr);
+        }
+        return backing(addr, len, n, alloc);
+    }
+
+    // Return the host pointer backing `addr` and the number of bytes `n`
+    // (at most `len`) that are contiguous from there. Unallocated sparse pages
+    // are only created if `alloc` is set, otherwise `nullptr` is returned.
+    uint8_t *backing(uint64_t addr, size_t len, size_t &n, bool alloc) {
+        if (flat && addr < FLAT_SIZE) {
+            n = std::min<uint64_t>(len, FLAT_SIZE - addr);
+            if (alloc) mark_touched(addr, n);
+            return flat + addr;
+        }
+        uint64_t page_idx = addr >> ADDR_SHIFT;
+        size_t offset = addr & (PAGE_SIZE - 1);
+        n = std::min(len, PAGE_SIZE - offset);
+        auto it = pages.find(page_idx);
+        if (it == pages.end()) {
+            if (!alloc) return nullptr;
+            // `make_unique` value-initializes, i.e., zeroes, the page.
+            it = pages.emplace(page_idx,
+                               std::make_unique<uint8_t[]>(PAGE_SIZE))
+                     .first;
+        }
+        return it->second.get() + offset;
+    }
+
+    bool is_touched(uint64_t page_idx) const {
+        uint64_t w = touched[page_idx / 64].load(std::memory_order_relaxed);
+        return w >> (page_idx % 64) & 1;
+    }
+
+    void mark_touched(uint64_t addr, size_t len) {
+        uint64_t first = addr >> ADDR_SHIFT;
+        uint64_t last = (addr + len - 1) >> ADDR_SHIFT;
+        for (uint64_t p = first; p <= last; p++) {
+            uint64_t bit = (uint64_t)1 << (p % 64);
+            // Skip the atomic read-modify-write for pages marked before.
+            if (!(touched[p / 64].load(std::memory_order_relaxed) & bit))
+                touched[p / 64].fetch_or(bit, std::memory_order_relaxed);
+        }
+    }
+
+    // Expand a strobe word holding one strobe per byte into a byte mask,
+    // i.e., every non-zero byte becomes 0xff.
+    static uint64_t strb_mask(uint64_t s) {
+        constexpr uint64_t LO7 = 0x7f7f7f7f7f7f7f7full;
+        constexpr uint64_t HI = 0x8080808080808080ull;
+        uint64_t nz = (((s & LO7) + LO7) | s) & HI;
+        return (nz >> 7) * 0xff;
+    }
+
+    // Strobed copy, handled a 64-bit word at a time.
+    static void copy_strb(uint8_t *dst, const uint8_t *src,
+                          const uint8_t *strb, size_t len) {
+        if (!strb) {
+            std::memcpy(dst, src, len);
+            return;
+        }
+        size_t i = 0;
+        for (; i + 8 <= len; i += 8) {
+            uint64_t s;
+            std::memcpy(&s, strb + i, 8);
+            if (s == 0) continue;
+            uint64_t m = strb_mask(s);
+            if (m == ~(uint64_t)0) {
+                std::memcpy(dst + i, src + i, 8);
+                continue;
             }
+            uint64_t d, v;
+            std::memcpy(&d, dst + i, 8);
+            std::memcpy(&v, src + i, 8);
+            d = (d & ~m) | (v & m);
+            std::memcpy(dst + i, &d, 8);
         }
-        std::cout << std::dec;
+        for (; i < len; i++)
+            if (strb[i]) dst[i] = src[i];
     }
 };
 
 // The global memory all memory ports write into.
 extern GlobalMemory MEM;
 
+// Activity of the harts as reported by the RTL through DPI.
+struct ActivityMonitor {
+    // Per hart: whether it sleeps in WFI and whether its DMA is busy.
+    struct Status {
+        bool wfi = false;
+        bool dma_busy = false;
+    };
+    std::unordered_map<int, Status> harts;
+    // Number of harts which are awake or have a busy DMA.
+    unsigned active = 0;
+    // Whether the testharness has delivered all its wake-up events.
+    bool boot_done = false;
+
+    void update(int hart_id, bool wfi, bool dma_busy) {
+        auto it = harts.find(hart_id);
+        if (it == harts.end()) {
+            it = harts.emplace(hart_id, Status{true, false}).first;
+        }
+        bool was_active = !it->second.wfi || it->second.dma_busy;
+        it->second = {wfi, dma_busy};
+        bool is_active = !wfi || dma_busy;
+        active += is_active;
+        active -= was_active;
+    }
+
+    // There are no timers or external interrupts wired to the cluster, so once
+    // the boot wake-up has been delivered, a cluster with all harts in WFI and
+    // all DMAs idle cannot make progress anymore.
+    bool idle() const { return boot_done && !harts.empty() && !active; }
+};
+extern ActivityMonitor ACTIVITY;
+
 // The boot data generated along with the system RTL.
 struct BootData {
     uint64_t boot_addr;
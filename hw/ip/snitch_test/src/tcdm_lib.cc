@@ -0,0 +1,100 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Solderpad Hardware License, Version 0.51, see LICENSE for details.
+// SPDX-License-Identifier: SHL-0.51
+
+// Per-bank TCDM accesses and conflicts, enabled with `+tcdm_heatmap=<cycles>`.
+// Within the kernel window, `spatz_cluster.sv` accumulates the accesses and
+// conflicts to every bank per requester over windows of <cycles> cycles and
+// hands the non-zero counts to the testbench at the end of each window. The
+// requesters are the Snitch core and the Spatz VLSU of each core, the DMA and
+// the SoC port. A conflict is a cycle in which a request is not granted.
+//
+// The windows are written to a CSV file with the columns
+//   kernel,cycle,bank,requester,accesses,conflicts
+// where `kernel` counts the kernel windows and `cycle` is the first cycle of a
+// window. `util/trace/tcdm_heatmap.py` renders it as a bank x time heat map.
+// At the end of each kernel window, i.e., at `stop_kernel()`, the totals per
+// bank are printed.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/// DPI Functions.
+extern "C" {
+void tb_tcdm_open(int num_cores, int num_banks, const char *path);
+void tb_tcdm_window(long long cycle, int bank, int requester, int accesses,
+                    int conflicts);
+void tb_tcdm_kernel_end();
+void tb_tcdm_close();
+}
+
+namespace {
+
+struct Counts {
+    uint64_t accesses = 0;
+    uint64_t conflicts = 0;
+};
+
+FILE *file = nullptr;
+std::vector<std::string> requesters;
+// Totals of the current kernel window per bank and requester.
+std::vector<std::vector<Counts>> totals;
+unsigned kernel = 0;
+
+}  // namespace
+
+void tb_tcdm_open(int num_cores, int num_banks, const char *path) {
+    if (file) return;
+    file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "[TCDM] Could not open %s\n", path);
+        exit(1);
+    }
+    fprintf(file, "kernel,cycle,bank,requester,accesses,conflicts\n");
+    requesters.clear();
+    for (int i = 0; i < num_cores; i++) {
+        requesters.push_back("core" + std::to_string(i) + "_snitch");
+        requesters.push_back("core" + std::to_string(i) + "_vlsu");
+    }
+    requesters.push_back("dma");
+    requesters.push_back("soc");
+    totals.assign(num_banks, std::vector<Counts>(requesters.size()));
+    kernel = 0;
+}
+
+void tb_tcdm_window(long long cycle, int bank, int requester, int accesses,
+                    int conflicts) {
+    if (!file) return;
+    fprintf(file, "%u,%lld,%d,%s,%d,%d\n", kernel, cycle, bank,
+            requesters[requester].c_str(), accesses, conflicts);
+    totals[bank][requester].accesses += accesses;
+    totals[bank][requester].conflicts += conflicts;
+}
+
+void tb_tcdm_kernel_end() {
+    if (!file) return;
+    fprintf(stderr, "[TCDM] Kernel %u: accesses/conflicts per bank\n", kernel);
+    fprintf(stderr, "[TCDM] %4s", "bank");
+    for (auto &r : requesters) fprintf(stderr, " %21s", r.c_str());
+    fprintf(stderr, "\n");
+    for (size_t b = 0; b < totals.size(); b++) {
+        fprintf(stderr, "[TCDM] %4zu", b);
+        for (auto &c : totals[b]) {
+            fprintf(stderr, " %10llu/%10llu", (unsigned long long)c.accesses,
+                    (unsigned long long)c.conflicts);
+            c = Counts();
+        }
+        fprintf(stderr, "\n");
+    }
+    fflush(file);
+    kernel++;
+}
+
+void tb_tcdm_close() {
+    if (!file) return;
+    fclose(file);
+    file = nullptr;
+}
@@ -0,0 +1,154 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Solderpad Hardware License, Version 0.51, see LICENSE for details.
+// SPDX-License-Identifier: SHL-0.51
+
+// Binary instruction traces, written by the tracer in `spatz_cc.sv` with
+// `+trace_format=bin` or `+trace_format=bin.zst` instead of formatted text.
+//
+// A trace starts with a header describing the fields of its records:
+//   char magic[8] = "SNTRACE\0", u32 version, u32 hart_id, u32 num_fields,
+//   num_fields times { u8 bytes, u8 name_len, char name[name_len] }.
+// The fixed-size records follow, each holding the fields as little-endian
+// integers truncated to the given number of bytes. `util/bintrace.py`
+// reads them.
+
+#include <svdpi.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// DPI Functions.
+extern "C" {
+void tb_trace_open(int hart_id, const char *path);
+void tb_trace_snitch(int hart_id, long long sim_time, long long cycle,
+                     int priv, int pc, int insn, const svBitVecVal *extras);
+void tb_trace_close(int hart_id);
+}
+
+namespace {
+
+const uint32_t TRACE_VERSION = 1;
+
+struct Field {
+    const char *name;
+    uint8_t bytes;
+};
+
+// Fields of every record which are passed as separate arguments.
+const Field SNITCH_FIELDS[] = {
+    {"time", 8}, {"cycle", 8}, {"priv", 1}, {"pc", 4}, {"insn", 4},
+};
+
+// Fields of `snitch_pkg::snitch_trace_port_t` in declaration order, i.e.,
+// starting at the most significant one.
+const Field SNITCH_EXTRAS[] = {
+    {"source", 1},       {"stall", 1},       {"exception", 1},
+    {"rs1", 1},          {"rs2", 1},         {"rd", 1},
+    {"is_load", 1},      {"is_store", 1},    {"is_branch", 1},
+    {"pc_d", 4},         {"opa", 4},         {"opb", 4},
+    {"opa_select", 1},   {"opb_select", 1},  {"write_rd", 1},
+    {"csr_addr", 2},     {"writeback", 4},   {"gpr_rdata_1", 4},
+    {"ls_size", 1},      {"ld_result_32", 4}, {"lsu_rd", 1},
+    {"retire_load", 1},  {"alu_result", 4},  {"ls_amo", 1},
+    {"retire_acc", 1},   {"acc_pid", 1},     {"acc_pdata_32", 4},
+    {"fpu_offload", 1},  {"is_seq_insn", 1},
+};
+const size_t NUM_EXTRAS = sizeof(SNITCH_EXTRAS) / sizeof(Field);
+
+class TraceWriter {
+   public:
+    // Traces ending in `.zst` are compressed by a `zstd` process, which
+    // keeps the compression off the simulation thread.
+    TraceWriter(int hart_id, std::string path) {
+        bool zst = path.size() > 4 && path.substr(path.size() - 4) == ".zst";
+        if (zst && system("command -v zstd > /dev/null 2>&1") != 0) {
+            fprintf(stderr,
+                    "[Tracer] `zstd` not found, writing an uncompressed "
+                    "trace\n");
+            path.resize(path.size() - 4);
+            zst = false;
+        }
+        pipe = zst;
+        file = zst ? popen(("zstd -q -f -o '" + path + "'").c_str(), "w")
+                   : fopen(path.c_str(), "wb");
+        if (!file) {
+            fprintf(stderr, "[Tracer] Could not open %s\n", path.c_str());
+            exit(1);
+        }
+        setvbuf(file, nullptr, _IOFBF, 1 << 20);
+
+        fwrite("SNTRACE", 8, 1, file);
+        uint32_t hdr[3] = {TRACE_VERSION, (uint32_t)hart_id, 0};
+        for (auto &f : SNITCH_FIELDS) hdr[2]++, record_size += f.bytes;
+        for (auto &f : SNITCH_EXTRAS) hdr[2]++, record_size += f.bytes;
+        fwrite(hdr, sizeof(hdr), 1, file);
+        for (auto &f : SNITCH_FIELDS) write_field(f);
+        for (auto &f : SNITCH_EXTRAS) write_field(f);
+        record.resize(record_size);
+    }
+
+    ~TraceWriter() {
+        if (pipe)
+            pclose(file);
+        else
+            fclose(file);
+    }
+
+    void snitch(long long sim_time, long long cycle, int priv, int pc,
+                int insn, const svBitVecVal *extras) {
+        uint8_t *p = record.data();
+        put(p, sim_time, 8);
+        put(p, cycle, 8);
+        put(p, priv, 1);
+        put(p, (uint32_t)pc, 4);
+        put(p, (uint32_t)insn, 4);
+        // Every field of the packed struct is a `longint`, the last one
+        // occupies the least significant bits.
+        for (size_t i = 0; i < NUM_EXTRAS; i++) {
+            size_t w = 2 * (NUM_EXTRAS - 1 - i);
+            put(p, (uint64_t)extras[w + 1] << 32 | extras[w],
+                SNITCH_EXTRAS[i].bytes);
+        }
+        fwrite(record.data(), record_size, 1, file);
+    }
+
+   private:
+    FILE *file;
+    bool pipe;
+    size_t record_size = 0;
+    std::vector<uint8_t> record;
+
+    void write_field(const Field &f) {
+        uint8_t len = strlen(f.name);
+        fwrite(&f.bytes, 1, 1, file);
+        fwrite(&len, 1, 1, file);
+        fwrite(f.name, len, 1, file);
+    }
+
+    static void put(uint8_t *&p, uint64_t val, size_t bytes) {
+        for (size_t i = 0; i < bytes; i++) *p++ = val >> 8 * i;
+    }
+};
+
+std::map<int, std::unique_ptr<TraceWriter>> writers;
+
+}  // namespace
+
+void tb_trace_open(int hart_id, const char *path) {
+    writers[hart_id] = std::make_unique<TraceWriter>(hart_id, path);
+}
+
+void tb_trace_snitch(int hart_id, long long sim_time, long long cycle,
+                     int priv, int pc, int insn, const svBitVecVal *extras) {
+    auto it = writers.find(hart_id);
+    if (it != writers.end())
+        it->second->snitch(sim_time, cycle, priv, pc, insn, extras);
+}
+
+void tb_trace_close(int hart_id) { writers.erase(hart_id); }
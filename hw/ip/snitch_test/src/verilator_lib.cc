@@ -9,29 +9,223 @@
 #include "sim.hh"
 #include "tb_lib.hh"
 #include "verilated.h"
+#ifdef TB_SAVABLE
+#include "verilated_save.h"
+#endif
+#if defined(TB_TRACE_FST)
+#include "verilated_fst_c.h"
+#define TB_TRACE
+typedef VerilatedFstC VerilatedWave;
+#elif defined(TB_TRACE_VCD)
+#include "verilated_vcd_c.h"
+#define TB_TRACE
+typedef VerilatedVcdC VerilatedWave;
+#endif
 namespace sim {
 
 Sim* s;
 
-// Number of cycles between HTIF checks.
-const int HTIFTimeInterval = 200;
+// Number of cycles between HTIF checks if the binary has no `tohost` symbol to
+// watch.
+const int HTIFTimeInterval = 100;
 void sim_thread_main(void *arg) { ((Sim *)arg)->main(); }
 
 // Sim time.
 int TIME = 0;
 
+// The verilated model. Global such that it can be torn down once `fesvr` is
+// done, which writes out any profiling data the model collected.
+std::unique_ptr<Vtestharness> top;
+#ifdef TB_TRACE
+// Waveform of the model.
+std::unique_ptr<VerilatedWave> wave;
+#endif
+// Wall-clock time at which the simulation started.
+std::chrono::steady_clock::time_point start_time;
+
+// Whether the kernel window has opened and a checkpoint is due.
+bool checkpoint_pending = false;
+bool checkpoint_taken = false;
+
+// Current value of SPATZ_STATUS and whether it changed since the target last
+// yielded to the driver.
+bool probe = false;
+bool probe_changed = false;
+
+#ifdef TB_SAVABLE
+// A checkpoint holds the testbench state, the simulation memory, and the
+// model. `fesvr` itself is not serialized: it is only valid to resume with the
+// binary the checkpoint was taken with, which brings `fesvr` into the same
+// state once the binary is loaded. With `--restore-symbols`, a binary with the
+// same code suffices, see `Sim::restore_symbols`.
+template <typename Os>
+void save_state(Os &os, const Sim &sim) {
+    os.write(&sim.payload_hash, sizeof(sim.payload_hash));
+    os.write(&sim.code_hash, sizeof(sim.code_hash));
+    os.write(&TIME, sizeof(TIME));
+    bool watch_hit = MEM.watch_hit;
+    os.write(&watch_hit, sizeof(watch_hit));
+    uint64_t num_harts = ACTIVITY.harts.size();
+    os.write(&num_harts, sizeof(num_harts));
+    for (auto &h : ACTIVITY.harts) {
+        os.write(&h.first, sizeof(h.first));
+        os.write(&h.second, sizeof(h.second));
+    }
+    os.write(&ACTIVITY.active, sizeof(ACTIVITY.active));
+    os.write(&ACTIVITY.boot_done, sizeof(ACTIVITY.boot_done));
+    MEM.save(os);
+}
+
+template <typename Is>
+bool restore_state(Is &is, const Sim &sim) {
+    uint64_t payload_hash, code_hash;
+    is.read(&payload_hash, sizeof(payload_hash));
+    is.read(&code_hash, sizeof(code_hash));
+    if (payload_hash != sim.payload_hash &&
+        (sim.restore_symbols.empty() || code_hash != sim.code_hash))
+        return false;
+    is.read(&TIME, sizeof(TIME));
+    bool watch_hit;
+    is.read(&watch_hit, sizeof(watch_hit));
+    MEM.watch_hit = watch_hit;
+    uint64_t num_harts;
+    is.read(&num_harts, sizeof(num_harts));
+    ACTIVITY.harts.clear();
+    while (num_harts--) {
+        int hart_id;
+        ActivityMonitor::Status status;
+        is.read(&hart_id, sizeof(hart_id));
+        is.read(&status, sizeof(status));
+        ACTIVITY.harts[hart_id] = status;
+    }
+    is.read(&ACTIVITY.active, sizeof(ACTIVITY.active));
+    is.read(&ACTIVITY.boot_done, sizeof(ACTIVITY.boot_done));
+    MEM.restore(is);
+    return true;
+}
+#endif
+
+void save_checkpoint(const std::string &path, const Sim &sim) {
+#ifdef TB_SAVABLE
+    VerilatedSave os;
+    os.open(path.c_str());
+    if (!os.isOpen()) {
+        fprintf(stderr, "[TB] Could not open checkpoint %s\n", path.c_str());
+        exit(1);
+    }
+    save_state(os, sim);
+    os << *top;
+    os.close();
+    fprintf(stderr, "[TB] Saved checkpoint %s at cycle %d\n", path.c_str(),
+            TIME / 2);
+#else
+    fprintf(stderr, "[TB] Checkpoints need a model built with VLT_SAVABLE=1\n");
+    exit(1);
+#endif
+}
+
+void restore_checkpoint(const std::string &path, const Sim &sim) {
+#ifdef TB_SAVABLE
+    VerilatedRestore is;
+    is.open(path.c_str());
+    if (!is.isOpen()) {
+        fprintf(stderr, "[TB] Could not open checkpoint %s\n", path.c_str());
+        exit(1);
+    }
+    if (!restore_state(is, sim)) {
+        fprintf(stderr,
+                "[TB] Checkpoint %s was taken with a different binary\n",
+                path.c_str());
+        exit(1);
+    }
+    is >> *top;
+    is.close();
+    fprintf(stderr, "[TB] Restored checkpoint %s at cycle %d\n", path.c_str(),
+            TIME / 2);
+    // Replace the checkpointed contents of the requested symbols with the
+    // ones of this binary.
+    for (auto &symbol : sim.restore_data) {
+        MEM.write(symbol.addr, symbol.data.size(), symbol.data.data(),
+                  nullptr);
+        fprintf(stderr, "[TB] Reloaded %s (%zu bytes) from the binary\n",
+                symbol.name.c_str(), symbol.data.size());
+    }
+#else
+    fprintf(stderr, "[TB] Checkpoints need a model built with VLT_SAVABLE=1\n");
+    exit(1);
+#endif
+}
+
+// Open the waveform of the model.
+void open_wave(const std::string &path) {
+#ifdef TB_TRACE
+    wave = std::make_unique<VerilatedWave>();
+    top->trace(wave.get(), 99);
+    wave->open(path.c_str());
+    if (!wave->isOpen()) {
+        fprintf(stderr, "[TB] Could not open waveform %s\n", path.c_str());
+        exit(1);
+    }
+#else
+    fprintf(stderr, "[TB] Waveforms need a model built with VLT_TRACE\n");
+    exit(1);
+#endif
+}
+
+// Finalize and destroy the model.
+void finish() {
+    if (!top) return;
+    top->final();
+#ifdef TB_TRACE
+    if (wave) wave->close();
+    wave.reset();
+#endif
+    top.reset();
+}
+
 Sim::Sim(int argc, char **argv) : htif_t(argc, argv) {
+    // Start from scratch, there may have been a simulation before in batch
+    // mode.
+    TIME = 0;
+    MEM.clear();
+    MEM.watch_hit = false;
+    ACTIVITY = ActivityMonitor();
+    checkpoint_pending = checkpoint_taken = false;
+    probe = probe_changed = false;
+    Verilated::gotFinish(false);
     Verilated::commandArgs(argc, argv);
+    parse_tb_args(argc, argv);
 }
 
 void Sim::idle() { target.switch_to(); }
 
+// End the simulation with exit code 1 by posting an exit request to `tohost`
+// on behalf of the target, so `htif_t::run` returns regularly and a batch
+// continues with the next binary.
+void Sim::abort_run() {
+    auto it = symbols.find("tohost");
+    if (it == symbols.end()) {
+        finish();
+        exit(1);
+    }
+    uint64_t exit_request = (1 << 1) | 1;
+    MEM.write(it->second, sizeof(exit_request),
+              reinterpret_cast<const uint8_t *>(&exit_request), nullptr);
+    while (true) host->switch_to();
+}
+
 /// Execute the simulation.
 int Sim::run() {
     host = context_t::current();
     target.init(sim_thread_main, this);
 
     int exit_code = htif_t::run();
+    std::chrono::duration<double> wall =
+        std::chrono::steady_clock::now() - start_time;
+    cycles = TIME / 2;
+    fprintf(stderr, "[TB] Simulated %d cycles in %.3f s (%.1f kHz)\n",
+            TIME / 2, wall.count(), TIME / 2 / wall.count() / 1e3);
+    finish();
     if (exit_code > 0)
       fprintf(stderr, "[FAILURE] Finished with exit code %2d\n", exit_code);
     else
@@ -47,9 +241,17 @@ void Sim::main() {
     s = this;
 
     // Allocate the simulation state.
-    auto top = std::make_unique<Vtestharness>();
+    top = std::make_unique<Vtestharness>();
+    if (!restore_file.empty()) restore_checkpoint(restore_file, *this);
+    if (!wave_file.empty()) open_wave(wave_file);
+    start_time = std::chrono::steady_clock::now();
+
+    // The clock toggles every half-cycle and is high after odd ones.
+    bool clk_i = TIME & 1, rst_ni = 0;
 
-    bool clk_i = 0, rst_ni = 0;
+    // Half-cycles between unconditional HTIF checks.
+    uint64_t interval = 2 * htif_interval;
+    if (!interval && MEM.watches.empty()) interval = 2 * HTIFTimeInterval;
 
     while (!Verilated::gotFinish()) {
         clk_i = !clk_i;
@@ -58,14 +260,56 @@ void Sim::main() {
         top->rst_ni = rst_ni;
         // Evaluate the DUT.
         top->eval();
+#ifdef TB_TRACE
+        if (wave && (probe || !kernel_trace)) wave->dump(TIME);
+#endif
         // Increase global time.
         TIME++;
-        // Switch to the HTIF interface in regular intervals.
-        if (TIME % HTIFTimeInterval == 0) {
+        // Checkpoint in between two evaluations of the model.
+        if (checkpoint_pending) {
+            checkpoint_pending = false;
+            save_checkpoint(checkpoint_file, *this);
+        }
+        // Return to the driver embedding the simulation.
+        if (driver && ((uint64_t)TIME >= yield_time ||
+                       (yield_on_probe && probe_changed))) {
+            probe_changed = false;
+            driver->switch_to();
+            if (abort_requested) abort_run();
+        }
+        // Switch to the HTIF interface on HTIF traffic and, optionally, in
+        // regular intervals.
+        if (MEM.watch_hit || (interval && TIME % interval == 0)) {
             host->switch_to();
+            MEM.watch_hit = false;
+        }
+        // Once the cluster is idle for good, give `fesvr` a last chance to
+        // pick up an exit request and otherwise end the simulation.
+        if (idle_abort && ACTIVITY.idle()) {
+            host->switch_to();
+            fprintf(stderr,
+                    "[TB] All harts are idle without a wake-up source at "
+                    "cycle %d\n",
+                    TIME / 2);
+            abort_run();
         }
     }
 }
+
+int sim_time() { return TIME; }
+
+bool cluster_probe() { return probe; }
+
+// The performance counters of the cluster peripheral, read through a DPI
+// export of the testharness.
+std::vector<uint64_t> perf_counters() {
+    std::vector<uint64_t> counters;
+    if (!top) return counters;
+    svSetScope(svGetScopeFromName("TOP.testharness"));
+    int n = tb_num_perf_counters();
+    for (int i = 0; i < n; i++) counters.push_back(tb_perf_counter(i));
+    return counters;
+}
 }  // namespace sim
 
 // Verilator callback to get the current time.
@@ -80,6 +324,23 @@ void tb_memory_read(long long addr, int len, const svOpenArrayHandle data) {
     sim::MEM.read(addr, len, (uint8_t *)data_ptr);
 }
 
+void tb_hart_status(int hart_id, svBit wfi, svBit dma_busy) {
+    sim::ACTIVITY.update(hart_id, wfi, dma_busy);
+}
+
+void tb_boot_done() { sim::ACTIVITY.boot_done = true; }
+
+void tb_cluster_probe(svBit probe) {
+    sim::probe = probe;
+    sim::probe_changed = true;
+    if (probe && !sim::checkpoint_taken && !sim::s->checkpoint_file.empty()) {
+        sim::checkpoint_pending = true;
+        sim::checkpoint_taken = true;
+    }
+}
+
+svBit tb_kernel_window() { return sim::probe; }
+
 void tb_memory_write(long long addr, int len, const svOpenArrayHandle data,
                      const svOpenArrayHandle strb) {
     // std::cout << "[TB] Write " << std::hex << addr << std::dec << " (" << len
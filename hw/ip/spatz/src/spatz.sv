@@ -64,7 +64,9 @@ module spatz import spatz_pkg::*; import rvv_pkg::*; import fpnew_pkg::*; #(
     // FPU side channel
     input  roundmode_e                        fpu_rnd_mode_i,
     input  fmt_mode_t                         fpu_fmt_mode_i,
-    output status_t                           fpu_status_o
+    output status_t                           fpu_status_o,
+    // Performance events
+    output spatz_events_t                     spatz_events_o
   );
 
   ////////////////
@@ -96,6 +98,9 @@ module spatz import spatz_pkg::*; import rvv_pkg::*; import fpnew_pkg::*; #(
   logic       vsldu_rsp_valid;
   vsldu_rsp_t vsldu_rsp;
 
+  // Performance events
+  spatz_events_t spatz_events;
+
   /////////////////////
   //  FPU sequencer  //
   /////////////////////
@@ -266,7 +271,11 @@ module spatz import spatz_pkg::*; import rvv_pkg::*; import fpnew_pkg::*; #(
     .sb_id_i          (sb_id           ),
     .sb_wrote_result_i(vrf_wvalid      ),
     .sb_enable_i      ({sb_we, sb_re}  ),
-    .sb_enable_o      ({vrf_we, vrf_re})
+    .sb_enable_o      ({vrf_we, vrf_re}),
+    // Performance events
+    .issue_full_o     (spatz_events.issue_full    ),
+    .chaining_stall_o (spatz_events.chaining_stall),
+    .retired_vinsn_o  (spatz_events.retired_vinsn )
   );
 
   /////////
@@ -299,7 +308,10 @@ module spatz import spatz_pkg::*; import rvv_pkg::*; import fpnew_pkg::*; #(
     .vrf_rvalid_i     (vrf_rvalid[VFU_VD_RD:VFU_VS2_RD]                        ),
     .vrf_id_o         ({sb_id[SB_VFU_VD_WD], sb_id[SB_VFU_VD_RD:SB_VFU_VS2_RD]}),
     // FPU side-channel
-    .fpu_status_o     (fpu_status_o                                            )
+    .fpu_status_o     (fpu_status_o                                            ),
+    // Performance events
+    .busy_o           (spatz_events.vfu_busy                                   ),
+    .stall_o          (spatz_events.vfu_stall                                  )
   );
 
   //////////
@@ -338,7 +350,9 @@ module spatz import spatz_pkg::*; import rvv_pkg::*; import fpnew_pkg::*; #(
     .spatz_mem_rsp_i         (spatz_mem_rsp_i                                      ),
     .spatz_mem_rsp_valid_i   (spatz_mem_rsp_valid_i                                ),
     .spatz_mem_finished_o    (spatz_mem_finished                                   ),
-    .spatz_mem_str_finished_o(spatz_mem_str_finished                               )
+    .spatz_mem_str_finished_o(spatz_mem_str_finished                               ),
+    // Performance events
+    .stall_o                 (spatz_events.vlsu_stall                              )
   );
 
   ///////////
@@ -365,9 +379,23 @@ module spatz import spatz_pkg::*; import rvv_pkg::*; import fpnew_pkg::*; #(
     .vrf_re_o         (sb_re[VSLDU_VS2_RD]                            ),
     .vrf_rdata_i      (vrf_rdata[VSLDU_VS2_RD]                        ),
     .vrf_rvalid_i     (vrf_rvalid[VSLDU_VS2_RD]                       ),
-    .vrf_id_o         ({sb_id[SB_VSLDU_VD_WD], sb_id[SB_VSLDU_VS2_RD]})
+    .vrf_id_o         ({sb_id[SB_VSLDU_VD_WD], sb_id[SB_VSLDU_VS2_RD]}),
+    // Performance events
+    .busy_o           (spatz_events.vsldu_busy                        )
   );
 
+  ////////////////////////
+  // Performance Events //
+  ////////////////////////
+
+  // The VRF read ports are already filtered by the scoreboard, so a request
+  // which is not served lost the bank arbitration in the VRF
+  assign spatz_events.vrf_conflict    = $countones(vrf_re & ~vrf_rvalid);
+  // Memory requests not granted in this cycle
+  assign spatz_events.vlsu_tcdm_stall = $countones(spatz_mem_req_valid_o & ~spatz_mem_req_ready_i);
+
+  assign spatz_events_o = spatz_events;
+
   ////////////////
   // Assertions //
   ////////////////
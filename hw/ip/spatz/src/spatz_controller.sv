@@ -54,7 +54,11 @@ module spatz_controller
     input  logic             [NrVregfilePorts-1:0] sb_enable_i,
     input  logic             [NrWritePorts-1:0]    sb_wrote_result_i,
     output logic             [NrVregfilePorts-1:0] sb_enable_o,
-    input  spatz_id_t        [NrVregfilePorts-1:0] sb_id_i
+    input  spatz_id_t        [NrVregfilePorts-1:0] sb_id_i,
+    // Performance events
+    output logic                                   issue_full_o,
+    output logic                                   chaining_stall_o,
+    output logic             [2:0]                 retired_vinsn_o
   );
 
 // Include FF
@@ -599,4 +603,24 @@ module spatz_controller
   assign spatz_req_o       = spatz_req;
   assign spatz_req_valid_o = spatz_req_valid;
 
+  ////////////////////////
+  // Performance Events //
+  ////////////////////////
+
+  // The request buffer holds an instruction which could not be issued yet
+  assign issue_full_o = ~req_buffer_ready;
+
+  // A unit requested a VRF port, but the scoreboard held it back since the
+  // instruction depends on another one and must not chain to it
+  always_comb begin : proc_chaining_stall
+    chaining_stall_o = 1'b0;
+    for (int unsigned port = 0; port < NrVregfilePorts; port++)
+      if (sb_enable_i[port] && |scoreboard_q[sb_id_i[port]].deps && scoreboard_q[sb_id_i[port]].prevent_chaining)
+        chaining_stall_o = 1'b1;
+  end: proc_chaining_stall
+
+  // Instructions finished by the units, plus configuration instructions,
+  // which retire at issue
+  assign retired_vinsn_o = vfu_rsp_valid_i + vlsu_rsp_valid_i + vsldu_rsp_valid_i + retire_csr;
+
 endmodule : spatz_controller
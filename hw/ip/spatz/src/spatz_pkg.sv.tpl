@@ -368,6 +368,24 @@ package spatz_pkg;
     SB_VSLDU_VD_WD
   } sb_port_e;
 
+  ////////////////////////
+  // Performance Events //
+  ////////////////////////
+
+  // Event strobes of Spatz, counted by the performance counters in the
+  // cluster peripherals.
+  typedef struct packed {
+    logic       vfu_busy;        // VFU holds an instruction or has operations in flight
+    logic       vfu_stall;       // VFU holds an instruction but cannot issue a word
+    logic       vlsu_stall;      // VLSU cannot issue a load, all outstanding slots are taken
+    logic [3:0] vlsu_tcdm_stall; // number of VLSU memory requests not granted by the TCDM
+    logic       vsldu_busy;      // VSLDU holds an instruction
+    logic [2:0] vrf_conflict;    // number of VRF read requests stalled by a bank conflict
+    logic       chaining_stall;  // VRF access stalled since chaining is prevented
+    logic       issue_full;      // issued instruction waits in the controller
+    logic [2:0] retired_vinsn;   // number of vector instructions retired
+  } spatz_events_t;
+
   /////////////////////////
   //  FPU Configuration  //
   /////////////////////////
@@ -39,7 +39,10 @@ module spatz_vfu
     input  vrf_data_t  [2:0] vrf_rdata_i,
     input  logic       [2:0] vrf_rvalid_i,
     // FPU side channel
-    output status_t          fpu_status_o
+    output status_t          fpu_status_o,
+    // Performance events
+    output logic             busy_o,
+    output logic             stall_o
   );
 
 // Include FF
@@ -279,6 +282,12 @@ module spatz_vfu
     end
   end: control_proc
 
+  // The VFU is busy as long as it holds an instruction or its units have
+  // operations in flight. It stalls if it holds an instruction but cannot
+  // issue a word, e.g., waiting for operands or for a unit switch.
+  assign busy_o  = spatz_req_valid || is_ipu_busy || is_fpu_busy;
+  assign stall_o = spatz_req_valid && !word_issued;
+
   //////////////
   // Operands //
   //////////////
@@ -48,7 +48,9 @@ module spatz_vlsu
     input  logic           [NrMemPorts-1:0] spatz_mem_rsp_valid_i,
     // Memory Finished
     output logic                            spatz_mem_finished_o,
-    output logic                            spatz_mem_str_finished_o
+    output logic                            spatz_mem_str_finished_o,
+    // Performance events
+    output logic                            stall_o
   );
 
 // Include FF
@@ -1006,6 +1008,10 @@ module spatz_vlsu
 `endif
   end
 
+  // A load stalls on outstanding requests if it could access the memory, but
+  // its reorder buffer or offset queue ran out of slots
+  assign stall_o = mem_spatz_req_valid && mem_is_load && |(mem_operation_valid & (rob_full | offset_queue_full));
+
   ////////////////
   // Assertions //
   ////////////////
@@ -29,7 +29,9 @@ module spatz_vsldu
     output vrf_addr_t        vrf_raddr_o,
     output logic             vrf_re_o,
     input  vrf_data_t        vrf_rdata_i,
-    input  logic             vrf_rvalid_i
+    input  logic             vrf_rvalid_i,
+    // Performance events
+    output logic             busy_o
   );
 
 // Include FF
@@ -444,6 +446,9 @@ module spatz_vsldu
   assign vrf_re_o        = spatz_req.use_vs2 && (spatz_req_valid || prefetch_q) && running_q[spatz_req.id];
   assign vrf_req_valid_d = spatz_req_valid && spatz_req.use_vd && (vrf_re_o || !spatz_req.use_vs2) && (vrf_rvalid_i || !spatz_req.use_vs2) && !prefetch_q;
 
+  // Busy while holding an instruction or writing back its last word
+  assign busy_o = spatz_req_valid || vrf_req_valid_q;
+
   ////////////////////////
   // Address Generation //
   ////////////////////////
@@ -439,4 +439,46 @@ module axi_dma_tc_snitch_fe #(
   //--------------------------------------
   `FF(twod_req_q, twod_req_d, '0)
 
+  //--------------------------------------
+  // Tracer
+  //--------------------------------------
+  // pragma translate_off
+  // Log the issue and the completion of each transfer, as
+  // `<time> <cycle> issue <id> <src> <dst> <bytes> <repetitions>` and
+  // `<time> <cycle> done <id>`. Read by `util/trace/tracevis.py`.
+  int          dma_f;
+  string       dma_fn;
+  logic [63:0] dma_cycle;
+
+  initial begin
+    // Wait for `hart_id_i` to be assigned, see the tracer in `spatz_cc`.
+    /* verilator lint_off STMTDLY */
+    @(posedge clk_i);
+    /* verilator lint_on STMTDLY */
+    $system("mkdir logs -p");
+    $sformat(dma_fn, "logs/dma_trace_%05x.log", hart_id_i);
+    dma_f = $fopen(dma_fn, "w");
+  end
+
+  // verilog_lint: waive-start always-ff-non-blocking
+  always_ff @(posedge clk_i) begin
+    if (rst_ni) begin
+      dma_cycle++;
+      if (twod_req_valid && twod_req_ready)
+        $fwrite(dma_f, "%0t %0d issue %0d 0x%h 0x%h %0d %0d\n", $time, dma_cycle, next_id,
+          twod_req_d.src, twod_req_d.dst, twod_req_d.num_bytes,
+          twod_req_d.is_twod ? twod_req_d.num_repetitions : 1);
+      if (oned_trans_complete && twod_req_last_realigned)
+        $fwrite(dma_f, "%0t %0d done %0d\n", $time, dma_cycle, completed_id);
+    end else begin
+      dma_cycle <= '0;
+    end
+  end
+  // verilog_lint: waive-stop always-ff-non-blocking
+
+  final begin
+    $fclose(dma_f);
+  end
+  // pragma translate_on
+
 endmodule
@@ -13,6 +13,7 @@
 module spatz_cc
   import snitch_pkg::interrupts_t;
   import snitch_pkg::core_events_t;
+  import spatz_pkg::spatz_events_t;
   import fpnew_pkg::fpu_implementation_t; #(
     /// Address width of the buses
     parameter int                          unsigned        AddrWidth                = 0,
@@ -113,6 +114,7 @@ module spatz_cc
     output dma_events_t                  axi_dma_events_o,
     // Core event strobes
     output core_events_t                 core_events_o,
+    output spatz_events_t                spatz_events_o,
     input  addr_t                        tcdm_addr_base_i
   );
 
@@ -312,7 +314,8 @@ module spatz_cc
     .fp_lsu_mem_rsp_i        (fp_lsu_mem_rsp        ),
     .fpu_rnd_mode_i          (fpu_rnd_mode          ),
     .fpu_fmt_mode_i          (fpu_fmt_mode          ),
-    .fpu_status_o            (fpu_status            )
+    .fpu_status_o            (fpu_status            ),
+    .spatz_events_o          (spatz_events_o        )
   );
 
   for (genvar p = 0; p < NumMemPortsPerSpatz; p++) begin: gen_tcdm_assignment
@@ -479,8 +482,29 @@ module spatz_cc
   int           f;
   string        fn;
   logic  [63:0] cycle;
+  // With `+kernel_trace`, only trace while SPATZ_STATUS is set, i.e., within
+  // the kernel window marked by the benchmarks.
+  bit           kernel_trace;
+  // With `+trace_format=bin` or `+trace_format=bin.zst`, the testbench writes
+  // binary records instead of formatted text, see `trace_lib.cc`.
+  string        trace_format = "dasm";
+  bit           binary_trace;
+
+`ifdef TARGET_SNITCH_TEST
+  import "DPI-C" function bit tb_kernel_window();
+  import "DPI-C" function void tb_trace_open(input int hart_id, input string path);
+  import "DPI-C" function void tb_trace_snitch(input int hart_id, input longint sim_time,
+    input longint cycle, input int priv, input int pc, input int insn,
+    input snitch_pkg::snitch_trace_port_t extras);
+  import "DPI-C" function void tb_trace_close(input int hart_id);
+`endif
 
   initial begin
+    kernel_trace = $test$plusargs("kernel_trace");
+`ifdef TARGET_SNITCH_TEST
+    void'($value$plusargs("trace_format=%s", trace_format));
+    binary_trace = trace_format != "dasm";
+`endif
     // We need to schedule the assignment into a safe region, otherwise
     // `hart_id_i` won't have a value assigned at the beginning of the first
     // delta cycle.
@@ -488,7 +512,11 @@ module spatz_cc
     @(posedge clk_i);
     /* verilator lint_on STMTDLY */
     $system("mkdir logs -p");
-    $sformat(fn, "logs/trace_hart_%05x.dasm", hart_id_i);
+    $sformat(fn, "logs/trace_hart_%05x.%s", hart_id_i, trace_format);
+`ifdef TARGET_SNITCH_TEST
+    if (binary_trace) tb_trace_open(hart_id_i, fn);
+    else
+`endif
     f = $fopen(fn, "w");
     $display("[Tracer] Logging Hart %d to %s", hart_id_i, fn);
   end
@@ -500,8 +528,13 @@ module spatz_cc
     automatic snitch_pkg::snitch_trace_port_t extras_snitch;
     automatic snitch_pkg::fpu_trace_port_t extras_fpu;
     automatic snitch_pkg::fpu_sequencer_trace_port_t extras_fpu_seq_out;
+    automatic bit trace_on;
 
     if (rst_ni) begin
+      trace_on = 1'b1;
+`ifdef TARGET_SNITCH_TEST
+      if (kernel_trace) trace_on = tb_kernel_window();
+`endif
       extras_snitch = '{
         // State
         source      : snitch_pkg::SrcSnitch,
@@ -546,13 +579,22 @@ module spatz_cc
       // Trace snitch iff:
       // we are not stalled <==> we have issued and processed an instruction (including offloads)
       // OR we are retiring (issuing a writeback from) a load or accelerator instruction
-      if (!i_snitch.stall || i_snitch.retire_load || i_snitch.retire_acc) begin
-        $sformat(trace_entry, "%t %1d %8d 0x%h DASM(%h) #; %s\n",
-          $time, cycle, i_snitch.priv_lvl_q, i_snitch.pc_q, i_snitch.inst_data_i,
-          snitch_pkg::print_snitch_trace(extras_snitch));
-        $fwrite(f, trace_entry);
+      if (trace_on && (!i_snitch.stall || i_snitch.retire_load || i_snitch.retire_acc)) begin
+`ifdef TARGET_SNITCH_TEST
+        if (binary_trace)
+          tb_trace_snitch(hart_id_i, $time, cycle, i_snitch.priv_lvl_q, i_snitch.pc_q,
+            i_snitch.inst_data_i, extras_snitch);
+        else
+`endif
+        begin
+          $sformat(trace_entry, "%t %1d %8d 0x%h DASM(%h) #; %s\n",
+            $time, cycle, i_snitch.priv_lvl_q, i_snitch.pc_q, i_snitch.inst_data_i,
+            snitch_pkg::print_snitch_trace(extras_snitch));
+          $fwrite(f, trace_entry);
+        end
       end
-      if (FPEn) begin
+      // The binary format only carries Snitch records.
+      if (FPEn && trace_on && !binary_trace) begin
         // Trace FPU iff:
         // an incoming handshake on the accelerator bus occurs <==> an instruction was issued
         // OR an FPU result is ready to be written back to an FPR register or the bus
@@ -572,8 +614,82 @@ module spatz_cc
   end
 
   final begin
+`ifdef TARGET_SNITCH_TEST
+    if (binary_trace) tb_trace_close(hart_id_i);
+    else
+`endif
     $fclose(f);
   end
+
+`ifdef TARGET_SNITCH_TEST
+  // Report whether the core sleeps in WFI and whether its DMA is busy to the
+  // testbench, which uses it to detect a cluster that cannot make progress anymore.
+  import "DPI-C" function void tb_hart_status(input int hart_id, input bit wfi,
+                                              input bit dma_busy);
+
+  logic [1:0] status_q;
+
+  always_ff @(posedge clk_i) begin
+    if (!rst_ni) begin
+      status_q = '1;
+    end else if ({i_snitch.wfi_q, axi_dma_busy_o} != status_q) begin
+      status_q = {i_snitch.wfi_q, axi_dma_busy_o};
+      tb_hart_status(hart_id_i, i_snitch.wfi_q, axi_dma_busy_o);
+    end
+  end
+
+  // Statistical PC sampling with `+pc_sample=<cycles>`, see `prof_lib.cc`. Every
+  // <cycles> cycles, report the PC, whether the core sleeps in WFI, and whether
+  // Spatz holds a vector instruction. The retired calls and returns maintain the
+  // shadow call stack of the testbench.
+  import "DPI-C" function void tb_prof_open(input int hart_id, input string path);
+  import "DPI-C" function void tb_prof_sample(input int hart_id, input int pc,
+                                              input bit wfi, input bit spatz_busy);
+  import "DPI-C" function void tb_prof_call(input int hart_id, input int ret_addr);
+  import "DPI-C" function void tb_prof_ret(input int hart_id, input int target);
+  import "DPI-C" function void tb_prof_close(input int hart_id);
+
+  localparam logic [6:0] OpcodeJal  = 7'b1101111;
+  localparam logic [6:0] OpcodeJalr = 7'b1100111;
+
+  int unsigned pc_sample;
+  int unsigned pc_sample_cnt;
+
+  initial begin
+    if (!$value$plusargs("pc_sample=%d", pc_sample)) pc_sample = 0;
+    /* verilator lint_off STMTDLY */
+    @(posedge clk_i);
+    /* verilator lint_on STMTDLY */
+    if (pc_sample != 0) tb_prof_open(hart_id_i, "logs/pc_sample.folded");
+  end
+
+  always_ff @(posedge clk_i) begin
+    automatic logic [6:0] opcode = i_snitch.inst_data_i[6:0];
+    automatic logic [4:0] rd     = i_snitch.inst_data_i[11:7];
+    automatic logic [4:0] rs1    = i_snitch.inst_data_i[19:15];
+
+    if (!rst_ni) begin
+      pc_sample_cnt = 0;
+    end else if (pc_sample != 0) begin
+      if (!i_snitch.stall && !i_snitch.exception) begin
+        // Calls link `ra` or `t0`, returns jump to them without linking.
+        if ((opcode == OpcodeJal || opcode == OpcodeJalr) && (rd == 1 || rd == 5))
+          tb_prof_call(hart_id_i, i_snitch.pc_q + 4);
+        else if (opcode == OpcodeJalr && rd == 0 && (rs1 == 1 || rs1 == 5))
+          tb_prof_ret(hart_id_i, i_snitch.pc_d);
+      end
+      if (++pc_sample_cnt == pc_sample) begin
+        pc_sample_cnt = 0;
+        tb_prof_sample(hart_id_i, i_snitch.pc_q, i_snitch.wfi_q,
+                       |i_spatz.i_controller.running_insn_q);
+      end
+    end
+  end
+
+  final begin
+    if (pc_sample != 0) tb_prof_close(hart_id_i);
+  end
+`endif
   // verilog_lint: waive-stop always-ff-non-blocking
   // pragma translate_on
 
@@ -395,9 +395,10 @@ module spatz_cluster
   tcdm_req_t [NrTCDMPortsCores-1:0] tcdm_req;
   tcdm_rsp_t [NrTCDMPortsCores-1:0] tcdm_rsp;
 
-  core_events_t [NrCores-1:0] core_events;
-  tcdm_events_t               tcdm_events;
-  dma_events_t                dma_events;
+  core_events_t  [NrCores-1:0] core_events;
+  spatz_events_t [NrCores-1:0] spatz_events;
+  tcdm_events_t                tcdm_events;
+  dma_events_t                 dma_events;
   snitch_icache_pkg::icache_events_t [NrCores-1:0] icache_events;
 
   // 4. Memory Subsystem (Core side).
@@ -768,6 +769,7 @@ module spatz_cluster
       .axi_dma_perf_o   (/* Unused */                        ),
       .axi_dma_events_o (dma_core_events                     ),
       .core_events_o    (core_events[i]                      ),
+      .spatz_events_o   (spatz_events[i]                     ),
       .tcdm_addr_base_i (tcdm_start_address                  )
     );
     for (genvar j = 0; j < TcdmPorts; j++) begin : gen_tcdm_user
@@ -1006,6 +1008,7 @@ module spatz_cluster
     .reg_rsp_t     (reg_rsp_t     ),
     .tcdm_events_t (tcdm_events_t ),
     .dma_events_t  (dma_events_t  ),
+    .spatz_events_t(spatz_events_t),
     .NrCores       (NrCores       )
   ) i_snitch_cluster_peripheral (
     .clk_i                    (clk_i                 ),
@@ -1019,6 +1022,7 @@ module spatz_cluster
     .cl_clint_o               (cl_interrupt          ),
     .cluster_hart_base_id_i   (hart_base_id_i        ),
     .core_events_i            (core_events           ),
+    .spatz_events_i           (spatz_events          ),
     .tcdm_events_i            (tcdm_events           ),
     .dma_events_i             (dma_events            ),
     .icache_events_i          (icache_events         ),
@@ -1135,6 +1139,111 @@ module spatz_cluster
     .popcount_o ( tcdm_events.inc_congested )
   );
 
+  // pragma translate_off
+`ifdef TARGET_SNITCH_TEST
+  // With `+tcdm_heatmap=<cycles>`, accumulate the accesses and conflicts to
+  // each TCDM bank per requester over windows of <cycles> cycles within the
+  // kernel window and hand them to the testbench, see `tcdm_lib.cc`. The
+  // requesters are the Snitch core and the Spatz VLSU of each core, the DMA,
+  // and the SoC port.
+  import "DPI-C" function bit tb_kernel_window();
+  import "DPI-C" function void tb_tcdm_open(input int num_cores, input int num_banks,
+                                            input string path);
+  import "DPI-C" function void tb_tcdm_window(input longint cycle, input int bank,
+                                              input int requester, input int accesses,
+                                              input int conflicts);
+  import "DPI-C" function void tb_tcdm_kernel_end();
+  import "DPI-C" function void tb_tcdm_close();
+
+  localparam int unsigned NrTCDMRequesters = 2 * NrCores + 2;
+  localparam int unsigned TCDMRequesterDMA = 2 * NrCores;
+  localparam int unsigned TCDMRequesterSoC = 2 * NrCores + 1;
+  localparam int unsigned TCDMBankOffset   = $clog2(DataWidth/8);
+  localparam int unsigned TCDMBankSelWidth = cf_math_pkg::idx_width(NrBanks);
+
+  int unsigned     tcdm_heatmap;
+  int unsigned     tcdm_heatmap_acc [NrBanks][NrTCDMRequesters];
+  int unsigned     tcdm_heatmap_con [NrBanks][NrTCDMRequesters];
+  int unsigned     tcdm_heatmap_cnt;
+  longint unsigned tcdm_heatmap_cycle;
+  longint unsigned tcdm_heatmap_start;
+  bit              tcdm_heatmap_kernel;
+
+  initial begin
+    if (!$value$plusargs("tcdm_heatmap=%d", tcdm_heatmap)) tcdm_heatmap = 0;
+    if (tcdm_heatmap != 0) begin
+      $system("mkdir logs -p");
+      tb_tcdm_open(NrCores, NrBanks, "logs/tcdm_heatmap.csv");
+    end
+  end
+
+  // Hand the counts of the current window to the testbench and clear them.
+  function automatic void tcdm_heatmap_flush();
+    for (int b = 0; b < NrBanks; b++) begin
+      for (int r = 0; r < NrTCDMRequesters; r++) begin
+        if (tcdm_heatmap_acc[b][r] != 0 || tcdm_heatmap_con[b][r] != 0)
+          tb_tcdm_window(tcdm_heatmap_start, b, r, tcdm_heatmap_acc[b][r],
+                         tcdm_heatmap_con[b][r]);
+        tcdm_heatmap_acc[b][r] = 0;
+        tcdm_heatmap_con[b][r] = 0;
+      end
+    end
+    tcdm_heatmap_cnt   = 0;
+    tcdm_heatmap_start = tcdm_heatmap_cycle;
+  endfunction
+
+  // Count a request of `requester` to the bank selected by `addr`.
+  function automatic void tcdm_heatmap_count(tcdm_addr_t addr, int unsigned requester,
+                                             logic valid, logic ready);
+    automatic int unsigned bank = addr[TCDMBankOffset+:TCDMBankSelWidth];
+    if (valid) begin
+      tcdm_heatmap_acc[bank][requester]++;
+      if (!ready) tcdm_heatmap_con[bank][requester]++;
+    end
+  endfunction
+
+  // verilog_lint: waive-start always-ff-non-blocking
+  always_ff @(posedge clk_i) begin
+    automatic bit kernel;
+
+    if (rst_ni && tcdm_heatmap != 0) begin
+      tcdm_heatmap_cycle++;
+      kernel = tb_kernel_window();
+      if (kernel) begin
+        if (!tcdm_heatmap_kernel) tcdm_heatmap_flush();
+        // Spatz VLSU ports first, then the Snitch port of each core.
+        for (int unsigned p = 0; p < NrTCDMPortsCores; p++) begin
+          automatic int unsigned core = p / get_tcdm_ports(0);
+          automatic bit is_snitch = (p % get_tcdm_ports(0)) == spatz_pkg::N_FU;
+          tcdm_heatmap_count(tcdm_req[p].q.addr, 2 * core + (is_snitch ? 0 : 1),
+                             tcdm_req[p].q_valid, tcdm_rsp[p].q_ready);
+        end
+        tcdm_heatmap_count(axi_soc_req.q.addr, TCDMRequesterSoC, axi_soc_req.q_valid,
+                           axi_soc_rsp.q_ready);
+        // A DMA access covers all banks of a superbank and is always granted.
+        for (int unsigned sb = 0; sb < NrSuperBanks; sb++) begin
+          if (sb_dma_req[sb].q_valid) begin
+            for (int unsigned b = 0; b < BanksPerSuperBank; b++)
+              tcdm_heatmap_acc[sb * BanksPerSuperBank + b][TCDMRequesterDMA]++;
+          end
+        end
+        if (++tcdm_heatmap_cnt == tcdm_heatmap) tcdm_heatmap_flush();
+      end else if (tcdm_heatmap_kernel) begin
+        // `stop_kernel()` closed the kernel window.
+        tcdm_heatmap_flush();
+        tb_tcdm_kernel_end();
+      end
+      tcdm_heatmap_kernel = kernel;
+    end
+  end
+  // verilog_lint: waive-stop always-ff-non-blocking
+
+  final begin
+    if (tcdm_heatmap != 0) tb_tcdm_close();
+  end
+`endif
+  // pragma translate_on
+
   // -------------
   // Sanity Checks
   // -------------
@@ -16,6 +16,7 @@ module spatz_cluster_peripheral
   parameter type reg_rsp_t = logic,
   parameter type         tcdm_events_t = logic,
   parameter type         dma_events_t = logic,
+  parameter type         spatz_events_t = logic,
   // Nr of course in the cluster
   parameter logic [31:0] NrCores       = 0,
   /// Derived parameter *Do not override*
@@ -34,6 +35,7 @@ module spatz_cluster_peripheral
   output logic                       cluster_probe_o,
   input  logic [9:0]                 cluster_hart_base_id_i,
   input  core_events_t [NrCores-1:0] core_events_i,
+  input  spatz_events_t [NrCores-1:0] spatz_events_i,
   input  tcdm_events_t               tcdm_events_i,
   input  dma_events_t                dma_events_i,
   input  snitch_icache_pkg::icache_events_t [NrCores-1:0] icache_events_i
@@ -43,9 +45,11 @@ module spatz_cluster_peripheral
   tcdm_events_t tcdm_events_q;
   dma_events_t dma_events_q;
   snitch_icache_pkg::icache_events_t [NrCores-1:0] icache_events_q;
+  spatz_events_t [NrCores-1:0] spatz_events_q;
   `FF(tcdm_events_q, tcdm_events_i, '0)
   `FF(dma_events_q, dma_events_i, '0)
   `FF(icache_events_q, icache_events_i, '0)
+  `FF(spatz_events_q, spatz_events_i, '0)
 
   spatz_cluster_peripheral_reg2hw_t reg2hw;
   spatz_cluster_peripheral_hw2reg_t hw2reg;
@@ -63,7 +67,7 @@ module spatz_cluster_peripheral
     .hw2reg (hw2reg)
   );
 
-  logic [NumPerfCounters-1:0][47:0] perf_counter_d, perf_counter_q;
+  logic [NumPerfCounters-1:0][63:0] perf_counter_d, perf_counter_q;
   logic [31:0] cl_clint_d, cl_clint_q;
 
   // Wake-up logic: Bits in cl_clint_q can be set/cleared with writes to
@@ -88,6 +92,7 @@ module spatz_cluster_peripheral
   // Continuously assign the perf values.
   for (genvar i = 0; i < NumPerfCounters; i++) begin : gen_perf_assign
     assign hw2reg.perf_counter[i].d = perf_counter_q[i];
+    assign hw2reg.perf_counter_hi[i].d = perf_counter_q[i][63:32];
   end
 
   // The hardware barrier is external and always reads `0`.
@@ -97,7 +102,9 @@ module spatz_cluster_peripheral
     perf_counter_d = perf_counter_q;
     for (int i = 0; i < NumPerfCounters; i++) begin
       automatic core_events_t sel_core_events;
+      automatic spatz_events_t sel_spatz_events;
       sel_core_events = core_events_i[reg2hw.hart_select[i].q[$clog2(NrCores):0]];
+      sel_spatz_events = spatz_events_q[reg2hw.hart_select[i].q[$clog2(NrCores):0]];
       // Cycle
       if (reg2hw.perf_counter_enable[i].cycle.q) begin
         perf_counter_d[i]++;
@@ -234,6 +241,46 @@ module spatz_cluster_peripheral
         perf_counter_d[i] = perf_counter_d[i] +
               icache_events_q[reg2hw.hart_select[i].q].l0_stall;
       end
+      // Spatz VFU busy
+      else if (reg2hw.perf_counter_spatz_enable[i].vfu_busy.q) begin
+        perf_counter_d[i] = perf_counter_d[i] + sel_spatz_events.vfu_busy;
+      end
+      // Spatz VFU stall
+      else if (reg2hw.perf_counter_spatz_enable[i].vfu_stall.q) begin
+        perf_counter_d[i] = perf_counter_d[i] + sel_spatz_events.vfu_stall;
+      end
+      // Spatz VLSU stall on outstanding requests
+      else if (reg2hw.perf_counter_spatz_enable[i].vlsu_stall.q) begin
+        perf_counter_d[i] = perf_counter_d[i] + sel_spatz_events.vlsu_stall;
+      end
+      // Spatz VLSU TCDM ports not granted
+      else if (reg2hw.perf_counter_spatz_enable[i].vlsu_tcdm_stall.q) begin
+        perf_counter_d[i] = perf_counter_d[i] + sel_spatz_events.vlsu_tcdm_stall;
+      end
+      // Spatz VSLDU busy
+      else if (reg2hw.perf_counter_spatz_enable[i].vsldu_busy.q) begin
+        perf_counter_d[i] = perf_counter_d[i] + sel_spatz_events.vsldu_busy;
+      end
+      // Spatz VRF bank conflicts
+      else if (reg2hw.perf_counter_spatz_enable[i].vrf_conflict.q) begin
+        perf_counter_d[i] = perf_counter_d[i] + sel_spatz_events.vrf_conflict;
+      end
+      // Spatz chaining stall
+      else if (reg2hw.perf_counter_spatz_enable[i].chaining_stall.q) begin
+        perf_counter_d[i] = perf_counter_d[i] + sel_spatz_events.chaining_stall;
+      end
+      // Spatz issue queue full
+      else if (reg2hw.perf_counter_spatz_enable[i].issue_full.q) begin
+        perf_counter_d[i] = perf_counter_d[i] + sel_spatz_events.issue_full;
+      end
+      // Spatz retired vector instructions
+      else if (reg2hw.perf_counter_spatz_enable[i].retired_vinsn.q) begin
+        perf_counter_d[i] = perf_counter_d[i] + sel_spatz_events.retired_vinsn;
+      end
+      // Freeze all performance counters.
+      if (reg2hw.perf_counter_freeze.q) begin
+        perf_counter_d[i] = perf_counter_q[i];
+      end
       // Reset performance counter.
       if (reg2hw.perf_counter[i].qe) begin
         perf_counter_d[i] = reg2hw.perf_counter[i].q;
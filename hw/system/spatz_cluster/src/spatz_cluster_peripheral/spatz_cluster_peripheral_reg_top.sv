@@ -10,7 +10,7 @@
 module spatz_cluster_peripheral_reg_top #(
   parameter type reg_req_t = logic,
   parameter type reg_rsp_t = logic,
-  parameter int AW = 7
+  parameter int AW = 8
 ) (
   input logic clk_i,
   input logic rst_ni,
@@ -260,12 +260,12 @@ module spatz_cluster_peripheral_reg_top #(
   logic [9:0] hart_select_1_qs;
   logic [9:0] hart_select_1_wd;
   logic hart_select_1_we;
-  logic [47:0] perf_counter_0_qs;
-  logic [47:0] perf_counter_0_wd;
+  logic [63:0] perf_counter_0_qs;
+  logic [63:0] perf_counter_0_wd;
   logic perf_counter_0_we;
   logic perf_counter_0_re;
-  logic [47:0] perf_counter_1_qs;
-  logic [47:0] perf_counter_1_wd;
+  logic [63:0] perf_counter_1_qs;
+  logic [63:0] perf_counter_1_wd;
   logic perf_counter_1_we;
   logic perf_counter_1_re;
   logic [31:0] cl_clint_set_wd;
@@ -281,6 +281,67 @@ module spatz_cluster_peripheral_reg_top #(
   logic [31:0] cluster_boot_control_qs;
   logic [31:0] cluster_boot_control_wd;
   logic cluster_boot_control_we;
+  logic perf_counter_spatz_enable_0_vfu_busy_0_qs;
+  logic perf_counter_spatz_enable_0_vfu_busy_0_wd;
+  logic perf_counter_spatz_enable_0_vfu_busy_0_we;
+  logic perf_counter_spatz_enable_0_vfu_stall_0_qs;
+  logic perf_counter_spatz_enable_0_vfu_stall_0_wd;
+  logic perf_counter_spatz_enable_0_vfu_stall_0_we;
+  logic perf_counter_spatz_enable_0_vlsu_stall_0_qs;
+  logic perf_counter_spatz_enable_0_vlsu_stall_0_wd;
+  logic perf_counter_spatz_enable_0_vlsu_stall_0_we;
+  logic perf_counter_spatz_enable_0_vlsu_tcdm_stall_0_qs;
+  logic perf_counter_spatz_enable_0_vlsu_tcdm_stall_0_wd;
+  logic perf_counter_spatz_enable_0_vlsu_tcdm_stall_0_we;
+  logic perf_counter_spatz_enable_0_vsldu_busy_0_qs;
+  logic perf_counter_spatz_enable_0_vsldu_busy_0_wd;
+  logic perf_counter_spatz_enable_0_vsldu_busy_0_we;
+  logic perf_counter_spatz_enable_0_vrf_conflict_0_qs;
+  logic perf_counter_spatz_enable_0_vrf_conflict_0_wd;
+  logic perf_counter_spatz_enable_0_vrf_conflict_0_we;
+  logic perf_counter_spatz_enable_0_chaining_stall_0_qs;
+  logic perf_counter_spatz_enable_0_chaining_stall_0_wd;
+  logic perf_counter_spatz_enable_0_chaining_stall_0_we;
+  logic perf_counter_spatz_enable_0_issue_full_0_qs;
+  logic perf_counter_spatz_enable_0_issue_full_0_wd;
+  logic perf_counter_spatz_enable_0_issue_full_0_we;
+  logic perf_counter_spatz_enable_0_retired_vinsn_0_qs;
+  logic perf_counter_spatz_enable_0_retired_vinsn_0_wd;
+  logic perf_counter_spatz_enable_0_retired_vinsn_0_we;
+  logic perf_counter_spatz_enable_1_vfu_busy_1_qs;
+  logic perf_counter_spatz_enable_1_vfu_busy_1_wd;
+  logic perf_counter_spatz_enable_1_vfu_busy_1_we;
+  logic perf_counter_spatz_enable_1_vfu_stall_1_qs;
+  logic perf_counter_spatz_enable_1_vfu_stall_1_wd;
+  logic perf_counter_spatz_enable_1_vfu_stall_1_we;
+  logic perf_counter_spatz_enable_1_vlsu_stall_1_qs;
+  logic perf_counter_spatz_enable_1_vlsu_stall_1_wd;
+  logic perf_counter_spatz_enable_1_vlsu_stall_1_we;
+  logic perf_counter_spatz_enable_1_vlsu_tcdm_stall_1_qs;
+  logic perf_counter_spatz_enable_1_vlsu_tcdm_stall_1_wd;
+  logic perf_counter_spatz_enable_1_vlsu_tcdm_stall_1_we;
+  logic perf_counter_spatz_enable_1_vsldu_busy_1_qs;
+  logic perf_counter_spatz_enable_1_vsldu_busy_1_wd;
+  logic perf_counter_spatz_enable_1_vsldu_busy_1_we;
+  logic perf_counter_spatz_enable_1_vrf_conflict_1_qs;
+  logic perf_counter_spatz_enable_1_vrf_conflict_1_wd;
+  logic perf_counter_spatz_enable_1_vrf_conflict_1_we;
+  logic perf_counter_spatz_enable_1_chaining_stall_1_qs;
+  logic perf_counter_spatz_enable_1_chaining_stall_1_wd;
+  logic perf_counter_spatz_enable_1_chaining_stall_1_we;
+  logic perf_counter_spatz_enable_1_issue_full_1_qs;
+  logic perf_counter_spatz_enable_1_issue_full_1_wd;
+  logic perf_counter_spatz_enable_1_issue_full_1_we;
+  logic perf_counter_spatz_enable_1_retired_vinsn_1_qs;
+  logic perf_counter_spatz_enable_1_retired_vinsn_1_wd;
+  logic perf_counter_spatz_enable_1_retired_vinsn_1_we;
+  logic [31:0] perf_counter_hi_0_qs;
+  logic perf_counter_hi_0_re;
+  logic [31:0] perf_counter_hi_1_qs;
+  logic perf_counter_hi_1_re;
+  logic perf_counter_freeze_qs;
+  logic perf_counter_freeze_wd;
+  logic perf_counter_freeze_we;
 
   // Register instances
 
@@ -1964,7 +2025,7 @@ module spatz_cluster_peripheral_reg_top #(
   // R[perf_counter_0]: V(True)
 
   prim_subreg_ext #(
-    .DW    (48)
+    .DW    (64)
   ) u_perf_counter_0 (
     .re     (perf_counter_0_re),
     .we     (perf_counter_0_we),
@@ -1980,7 +2041,7 @@ module spatz_cluster_peripheral_reg_top #(
   // R[perf_counter_1]: V(True)
 
   prim_subreg_ext #(
-    .DW    (48)
+    .DW    (64)
   ) u_perf_counter_1 (
     .re     (perf_counter_1_re),
     .we     (perf_counter_1_we),
@@ -2120,9 +2181,527 @@ module spatz_cluster_peripheral_reg_top #(
   );
 
 
+  // Subregister 0 of Multireg perf_counter_spatz_enable
+  // R[perf_counter_spatz_enable_0]: V(False)
 
+  // F[vfu_busy_0]: 0:0
+  prim_subreg #(
+    .DW      (1),
+    .SWACCESS("RW"),
+    .RESVAL  (1'h0)
+  ) u_perf_counter_spatz_enable_0_vfu_busy_0 (
+    .clk_i   (clk_i    ),
+    .rst_ni  (rst_ni  ),
+
+    // from register interface
+    .we     (perf_counter_spatz_enable_0_vfu_busy_0_we),
+    .wd     (perf_counter_spatz_enable_0_vfu_busy_0_wd),
+
+    // from internal hardware
+    .de     (1'b0),
+    .d      ('0  ),
+
+    // to internal hardware
+    .qe     (),
+    .q      (reg2hw.perf_counter_spatz_enable[0].vfu_busy.q ),
+
+    // to register interface (read)
+    .qs     (perf_counter_spatz_enable_0_vfu_busy_0_qs)
+  );
+
+  // F[vfu_stall_0]: 1:1
+  prim_subreg #(
+    .DW      (1),
+    .SWACCESS("RW"),
+    .RESVAL  (1'h0)
+  ) u_perf_counter_spatz_enable_0_vfu_stall_0 (
+    .clk_i   (clk_i    ),
+    .rst_ni  (rst_ni  ),
+
+    // from register interface
+    .we     (perf_counter_spatz_enable_0_vfu_stall_0_we),
+    .wd     (perf_counter_spatz_enable_0_vfu_stall_0_wd),
+
+    // from internal hardware
+    .de     (1'b0),
+    .d      ('0  ),
+
+    // to internal hardware
+    .qe     (),
+    .q      (reg2hw.perf_counter_spatz_enable[0].vfu_stall.q ),
+
+    // to register interface (read)
+    .qs     (perf_counter_spatz_enable_0_vfu_stall_0_qs)
+  );
+
+  // F[vlsu_stall_0]: 2:2
+  prim_subreg #(
+    .DW      (1),
+    .SWACCESS("RW"),
+    .RESVAL  (1'h0)
+  ) u_perf_counter_spatz_enable_0_vlsu_stall_0 (
+    .clk_i   (clk_i    ),
+    .rst_ni  (rst_ni  ),
+
+    // from register interface
+    .we     (perf_counter_spatz_enable_0_vlsu_stall_0_we),
+    .wd     (perf_counter_spatz_enable_0_vlsu_stall_0_wd),
+
+    // from internal hardware
+    .de     (1'b0),
+    .d      ('0  ),
+
+    // to internal hardware
+    .qe     (),
+    .q      (reg2hw.perf_counter_spatz_enable[0].vlsu_stall.q ),
 
-  logic [11:0] addr_hit;
+    // to register interface (read)
+    .qs     (perf_counter_spatz_enable_0_vlsu_stall_0_qs)
+  );
+
+  // F[vlsu_tcdm_stall_0]: 3:3
+  prim_subreg #(
+    .DW      (1),
+    .SWACCESS("RW"),
+    .RESVAL  (1'h0)
+  ) u_perf_counter_spatz_enable_0_vlsu_tcdm_stall_0 (
+    .clk_i   (clk_i    ),
+    .rst_ni  (rst_ni  ),
+
+    // from register interface
+    .we     (perf_counter_spatz_enable_0_vlsu_tcdm_stall_0_we),
+    .wd     (perf_counter_spatz_enable_0_vlsu_tcdm_stall_0_wd),
+
+    // from internal hardware
+    .de     (1'b0),
+    .d      ('0  ),
+
+    // to internal hardware
+    .qe     (),
+    .q      (reg2hw.perf_counter_spatz_enable[0].vlsu_tcdm_stall.q ),
+
+    // to register interface (read)
+    .qs     (perf_counter_spatz_enable_0_vlsu_tcdm_stall_0_qs)
+  );
+
+  // F[vsldu_busy_0]: 4:4
+  prim_subreg #(
+    .DW      (1),
+    .SWACCESS("RW"),
+    .RESVAL  (1'h0)
+  ) u_perf_counter_spatz_enable_0_vsldu_busy_0 (
+    .clk_i   (clk_i    ),
+    .rst_ni  (rst_ni  ),
+
+    // from register interface
+    .we     (perf_counter_spatz_enable_0_vsldu_busy_0_we),
+    .wd     (perf_counter_spatz_enable_0_vsldu_busy_0_wd),
+
+    // from internal hardware
+    .de     (1'b0),
+    .d      ('0  ),
+
+    // to internal hardware
+    .qe     (),
+    .q      (reg2hw.perf_counter_spatz_enable[0].vsldu_busy.q ),
+
+    // to register interface (read)
+    .qs     (perf_counter_spatz_enable_0_vsldu_busy_0_qs)
+  );
+
+  // F[vrf_conflict_0]: 5:5
+  prim_subreg #(
+    .DW      (1),
+    .SWACCESS("RW"),
+    .RESVAL  (1'h0)
+  ) u_perf_counter_spatz_enable_0_vrf_conflict_0 (
+    .clk_i   (clk_i    ),
+    .rst_ni  (rst_ni  ),
+
+    // from register interface
+    .we     (perf_counter_spatz_enable_0_vrf_conflict_0_we),
+    .wd     (perf_counter_spatz_enable_0_vrf_conflict_0_wd),
+
+    // from internal hardware
+    .de     (1'b0),
+    .d      ('0  ),
+
+    // to internal hardware
+    .qe     (),
+    .q      (reg2hw.perf_counter_spatz_enable[0].vrf_conflict.q ),
+
+    // to register interface (read)
+    .qs     (perf_counter_spatz_enable_0_vrf_conflict_0_qs)
+  );
+
+  // F[chaining_stall_0]: 6:6
+  prim_subreg #(
+    .DW      (1),
+    .SWACCESS("RW"),
+    .RESVAL  (1'h0)
+  ) u_perf_counter_spatz_enable_0_chaining_stall_0 (
+    .clk_i   (clk_i    ),
+    .rst_ni  (rst_ni  ),
+
+    // from register interface
+    .we     (perf_counter_spatz_enable_0_chaining_stall_0_we),
+    .wd     (perf_counter_spatz_enable_0_chaining_stall_0_wd),
+
+    // from internal hardware
+    .de     (1'b0),
+    .d      ('0  ),
+
+    // to internal hardware
+    .qe     (),
+    .q      (reg2hw.perf_counter_spatz_enable[0].chaining_stall.q ),
+
+    // to register interface (read)
+    .qs     (perf_counter_spatz_enable_0_chaining_stall_0_qs)
+  );
+
+  // F[issue_full_0]: 7:7
+  prim_subreg #(
+    .DW      (1),
+    .SWACCESS("RW"),
+    .RESVAL  (1'h0)
+  ) u_perf_counter_spatz_enable_0_issue_full_0 (
+    .clk_i   (clk_i    ),
+    .rst_ni  (rst_ni  ),
+
+    // from register interface
+    .we     (perf_counter_spatz_enable_0_issue_full_0_we),
+    .wd     (perf_counter_spatz_enable_0_issue_full_0_wd),
+
+    // from internal hardware
+    .de     (1'b0),
+    .d      ('0  ),
+
+    // to internal hardware
+    .qe     (),
+    .q      (reg2hw.perf_counter_spatz_enable[0].issue_full.q ),
+
+    // to register interface (read)
+    .qs     (perf_counter_spatz_enable_0_issue_full_0_qs)
+  );
+
+  // F[retired_vinsn_0]: 8:8
+  prim_subreg #(
+    .DW      (1),
+    .SWACCESS("RW"),
+    .RESVAL  (1'h0)
+  ) u_perf_counter_spatz_enable_0_retired_vinsn_0 (
+    .clk_i   (clk_i    ),
+    .rst_ni  (rst_ni  ),
+
+    // from register interface
+    .we     (perf_counter_spatz_enable_0_retired_vinsn_0_we),
+    .wd     (perf_counter_spatz_enable_0_retired_vinsn_0_wd),
+
+    // from internal hardware
+    .de     (1'b0),
+    .d      ('0  ),
+
+    // to internal hardware
+    .qe     (),
+    .q      (reg2hw.perf_counter_spatz_enable[0].retired_vinsn.q ),
+
+    // to register interface (read)
+    .qs     (perf_counter_spatz_enable_0_retired_vinsn_0_qs)
+  );
+
+
+  // Subregister 1 of Multireg perf_counter_spatz_enable
+  // R[perf_counter_spatz_enable_1]: V(False)
+
+  // F[vfu_busy_1]: 0:0
+  prim_subreg #(
+    .DW      (1),
+    .SWACCESS("RW"),
+    .RESVAL  (1'h0)
+  ) u_perf_counter_spatz_enable_1_vfu_busy_1 (
+    .clk_i   (clk_i    ),
+    .rst_ni  (rst_ni  ),
+
+    // from register interface
+    .we     (perf_counter_spatz_enable_1_vfu_busy_1_we),
+    .wd     (perf_counter_spatz_enable_1_vfu_busy_1_wd),
+
+    // from internal hardware
+    .de     (1'b0),
+    .d      ('0  ),
+
+    // to internal hardware
+    .qe     (),
+    .q      (reg2hw.perf_counter_spatz_enable[1].vfu_busy.q ),
+
+    // to register interface (read)
+    .qs     (perf_counter_spatz_enable_1_vfu_busy_1_qs)
+  );
+
+  // F[vfu_stall_1]: 1:1
+  prim_subreg #(
+    .DW      (1),
+    .SWACCESS("RW"),
+    .RESVAL  (1'h0)
+  ) u_perf_counter_spatz_enable_1_vfu_stall_1 (
+    .clk_i   (clk_i    ),
+    .rst_ni  (rst_ni  ),
+
+    // from register interface
+    .we     (perf_counter_spatz_enable_1_vfu_stall_1_we),
+    .wd     (perf_counter_spatz_enable_1_vfu_stall_1_wd),
+
+    // from internal hardware
+    .de     (1'b0),
+    .d      ('0  ),
+
+    // to internal hardware
+    .qe     (),
+    .q      (reg2hw.perf_counter_spatz_enable[1].vfu_stall.q ),
+
+    // to register interface (read)
+    .qs     (perf_counter_spatz_enable_1_vfu_stall_1_qs)
+  );
+
+  // F[vlsu_stall_1]: 2:2
+  prim_subreg #(
+    .DW      (1),
+    .SWACCESS("RW"),
+    .RESVAL  (1'h0)
+  ) u_perf_counter_spatz_enable_1_vlsu_stall_1 (
+    .clk_i   (clk_i    ),
+    .rst_ni  (rst_ni  ),
+
+    // from register interface
+    .we     (perf_counter_spatz_enable_1_vlsu_stall_1_we),
+    .wd     (perf_counter_spatz_enable_1_vlsu_stall_1_wd),
+
+    // from internal hardware
+    .de     (1'b0),
+    .d      ('0  ),
+
+    // to internal hardware
+    .qe     (),
+    .q      (reg2hw.perf_counter_spatz_enable[1].vlsu_stall.q ),
+
+    // to register interface (read)
+    .qs     (perf_counter_spatz_enable_1_vlsu_stall_1_qs)
+  );
+
+  // F[vlsu_tcdm_stall_1]: 3:3
+  prim_subreg #(
+    .DW      (1),
+    .SWACCESS("RW"),
+    .RESVAL  (1'h0)
+  ) u_perf_counter_spatz_enable_1_vlsu_tcdm_stall_1 (
+    .clk_i   (clk_i    ),
+    .rst_ni  (rst_ni  ),
+
+    // from register interface
+    .we     (perf_counter_spatz_enable_1_vlsu_tcdm_stall_1_we),
+    .wd     (perf_counter_spatz_enable_1_vlsu_tcdm_stall_1_wd),
+
+    // from internal hardware
+    .de     (1'b0),
+    .d      ('0  ),
+
+    // to internal hardware
+    .qe     (),
+    .q      (reg2hw.perf_counter_spatz_enable[1].vlsu_tcdm_stall.q ),
+
+    // to register interface (read)
+    .qs     (perf_counter_spatz_enable_1_vlsu_tcdm_stall_1_qs)
+  );
+
+  // F[vsldu_busy_1]: 4:4
+  prim_subreg #(
+    .DW      (1),
+    .SWACCESS("RW"),
+    .RESVAL  (1'h0)
+  ) u_perf_counter_spatz_enable_1_vsldu_busy_1 (
+    .clk_i   (clk_i    ),
+    .rst_ni  (rst_ni  ),
+
+    // from register interface
+    .we     (perf_counter_spatz_enable_1_vsldu_busy_1_we),
+    .wd     (perf_counter_spatz_enable_1_vsldu_busy_1_wd),
+
+    // from internal hardware
+    .de     (1'b0),
+    .d      ('0  ),
+
+    // to internal hardware
+    .qe     (),
+    .q      (reg2hw.perf_counter_spatz_enable[1].vsldu_busy.q ),
+
+    // to register interface (read)
+    .qs     (perf_counter_spatz_enable_1_vsldu_busy_1_qs)
+  );
+
+  // F[vrf_conflict_1]: 5:5
+  prim_subreg #(
+    .DW      (1),
+    .SWACCESS("RW"),
+    .RESVAL  (1'h0)
+  ) u_perf_counter_spatz_enable_1_vrf_conflict_1 (
+    .clk_i   (clk_i    ),
+    .rst_ni  (rst_ni  ),
+
+    // from register interface
+    .we     (perf_counter_spatz_enable_1_vrf_conflict_1_we),
+    .wd     (perf_counter_spatz_enable_1_vrf_conflict_1_wd),
+
+    // from internal hardware
+    .de     (1'b0),
+    .d      ('0  ),
+
+    // to internal hardware
+    .qe     (),
+    .q      (reg2hw.perf_counter_spatz_enable[1].vrf_conflict.q ),
+
+    // to register interface (read)
+    .qs     (perf_counter_spatz_enable_1_vrf_conflict_1_qs)
+  );
+
+  // F[chaining_stall_1]: 6:6
+  prim_subreg #(
+    .DW      (1),
+    .SWACCESS("RW"),
+    .RESVAL  (1'h0)
+  ) u_perf_counter_spatz_enable_1_chaining_stall_1 (
+    .clk_i   (clk_i    ),
+    .rst_ni  (rst_ni  ),
+
+    // from register interface
+    .we     (perf_counter_spatz_enable_1_chaining_stall_1_we),
+    .wd     (perf_counter_spatz_enable_1_chaining_stall_1_wd),
+
+    // from internal hardware
+    .de     (1'b0),
+    .d      ('0  ),
+
+    // to internal hardware
+    .qe     (),
+    .q      (reg2hw.perf_counter_spatz_enable[1].chaining_stall.q ),
+
+    // to register interface (read)
+    .qs     (perf_counter_spatz_enable_1_chaining_stall_1_qs)
+  );
+
+  // F[issue_full_1]: 7:7
+  prim_subreg #(
+    .DW      (1),
+    .SWACCESS("RW"),
+    .RESVAL  (1'h0)
+  ) u_perf_counter_spatz_enable_1_issue_full_1 (
+    .clk_i   (clk_i    ),
+    .rst_ni  (rst_ni  ),
+
+    // from register interface
+    .we     (perf_counter_spatz_enable_1_issue_full_1_we),
+    .wd     (perf_counter_spatz_enable_1_issue_full_1_wd),
+
+    // from internal hardware
+    .de     (1'b0),
+    .d      ('0  ),
+
+    // to internal hardware
+    .qe     (),
+    .q      (reg2hw.perf_counter_spatz_enable[1].issue_full.q ),
+
+    // to register interface (read)
+    .qs     (perf_counter_spatz_enable_1_issue_full_1_qs)
+  );
+
+  // F[retired_vinsn_1]: 8:8
+  prim_subreg #(
+    .DW      (1),
+    .SWACCESS("RW"),
+    .RESVAL  (1'h0)
+  ) u_perf_counter_spatz_enable_1_retired_vinsn_1 (
+    .clk_i   (clk_i    ),
+    .rst_ni  (rst_ni  ),
+
+    // from register interface
+    .we     (perf_counter_spatz_enable_1_retired_vinsn_1_we),
+    .wd     (perf_counter_spatz_enable_1_retired_vinsn_1_wd),
+
+    // from internal hardware
+    .de     (1'b0),
+    .d      ('0  ),
+
+    // to internal hardware
+    .qe     (),
+    .q      (reg2hw.perf_counter_spatz_enable[1].retired_vinsn.q ),
+
+    // to register interface (read)
+    .qs     (perf_counter_spatz_enable_1_retired_vinsn_1_qs)
+  );
+
+
+  // Subregister 0 of Multireg perf_counter_hi
+  // R[perf_counter_hi_0]: V(True)
+
+  prim_subreg_ext #(
+    .DW    (32)
+  ) u_perf_counter_hi_0 (
+    .re     (perf_counter_hi_0_re),
+    .we     (1'b0),
+    .wd     ('0),
+    .d      (hw2reg.perf_counter_hi[0].d),
+    .qre    (),
+    .qe     (),
+    .q      (),
+    .qs     (perf_counter_hi_0_qs)
+  );
+
+  // Subregister 1 of Multireg perf_counter_hi
+  // R[perf_counter_hi_1]: V(True)
+
+  prim_subreg_ext #(
+    .DW    (32)
+  ) u_perf_counter_hi_1 (
+    .re     (perf_counter_hi_1_re),
+    .we     (1'b0),
+    .wd     ('0),
+    .d      (hw2reg.perf_counter_hi[1].d),
+    .qre    (),
+    .qe     (),
+    .q      (),
+    .qs     (perf_counter_hi_1_qs)
+  );
+
+
+  // R[perf_counter_freeze]: V(False)
+
+  prim_subreg #(
+    .DW      (1),
+    .SWACCESS("RW"),
+    .RESVAL  (1'h0)
+  ) u_perf_counter_freeze (
+    .clk_i   (clk_i    ),
+    .rst_ni  (rst_ni  ),
+
+    // from register interface
+    .we     (perf_counter_freeze_we),
+    .wd     (perf_counter_freeze_wd),
+
+    // from internal hardware
+    .de     (1'b0),
+    .d      ('0  ),
+
+    // to internal hardware
+    .qe     (),
+    .q      (reg2hw.perf_counter_freeze.q ),
+
+    // to register interface (read)
+    .qs     (perf_counter_freeze_qs)
+  );
+
+
+
+
+  logic [16:0] addr_hit;
   always_comb begin
     addr_hit = '0;
     addr_hit[ 0] = (reg_addr == SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_ENABLE_0_OFFSET);
@@ -2137,6 +2716,11 @@ module spatz_cluster_peripheral_reg_top #(
     addr_hit[ 9] = (reg_addr == SPATZ_CLUSTER_PERIPHERAL_ICACHE_PREFETCH_ENABLE_OFFSET);
     addr_hit[10] = (reg_addr == SPATZ_CLUSTER_PERIPHERAL_SPATZ_STATUS_OFFSET);
     addr_hit[11] = (reg_addr == SPATZ_CLUSTER_PERIPHERAL_CLUSTER_BOOT_CONTROL_OFFSET);
+    addr_hit[12] = (reg_addr == SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_SPATZ_ENABLE_0_OFFSET);
+    addr_hit[13] = (reg_addr == SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_SPATZ_ENABLE_1_OFFSET);
+    addr_hit[14] = (reg_addr == SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_HI_0_OFFSET);
+    addr_hit[15] = (reg_addr == SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_HI_1_OFFSET);
+    addr_hit[16] = (reg_addr == SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_FREEZE_OFFSET);
   end
 
   assign addrmiss = (reg_re || reg_we) ? ~|addr_hit : 1'b0 ;
@@ -2155,7 +2739,12 @@ module spatz_cluster_peripheral_reg_top #(
                (addr_hit[ 8] & (|(SPATZ_CLUSTER_PERIPHERAL_PERMIT[ 8] & ~reg_be))) |
                (addr_hit[ 9] & (|(SPATZ_CLUSTER_PERIPHERAL_PERMIT[ 9] & ~reg_be))) |
                (addr_hit[10] & (|(SPATZ_CLUSTER_PERIPHERAL_PERMIT[10] & ~reg_be))) |
-               (addr_hit[11] & (|(SPATZ_CLUSTER_PERIPHERAL_PERMIT[11] & ~reg_be)))));
+               (addr_hit[11] & (|(SPATZ_CLUSTER_PERIPHERAL_PERMIT[11] & ~reg_be))) |
+               (addr_hit[12] & (|(SPATZ_CLUSTER_PERIPHERAL_PERMIT[12] & ~reg_be))) |
+               (addr_hit[13] & (|(SPATZ_CLUSTER_PERIPHERAL_PERMIT[13] & ~reg_be))) |
+               (addr_hit[14] & (|(SPATZ_CLUSTER_PERIPHERAL_PERMIT[14] & ~reg_be))) |
+               (addr_hit[15] & (|(SPATZ_CLUSTER_PERIPHERAL_PERMIT[15] & ~reg_be))) |
+               (addr_hit[16] & (|(SPATZ_CLUSTER_PERIPHERAL_PERMIT[16] & ~reg_be))))));
   end
 
   assign perf_counter_enable_0_cycle_0_we = addr_hit[0] & reg_we & !reg_error;
@@ -2351,11 +2940,11 @@ module spatz_cluster_peripheral_reg_top #(
   assign hart_select_1_wd = reg_wdata[9:0];
 
   assign perf_counter_0_we = addr_hit[4] & reg_we & !reg_error;
-  assign perf_counter_0_wd = reg_wdata[47:0];
+  assign perf_counter_0_wd = reg_wdata[63:0];
   assign perf_counter_0_re = addr_hit[4] & reg_re & !reg_error;
 
   assign perf_counter_1_we = addr_hit[5] & reg_we & !reg_error;
-  assign perf_counter_1_wd = reg_wdata[47:0];
+  assign perf_counter_1_wd = reg_wdata[63:0];
   assign perf_counter_1_re = addr_hit[5] & reg_re & !reg_error;
 
   assign cl_clint_set_we = addr_hit[6] & reg_we & !reg_error;
@@ -2375,6 +2964,67 @@ module spatz_cluster_peripheral_reg_top #(
   assign cluster_boot_control_we = addr_hit[11] & reg_we & !reg_error;
   assign cluster_boot_control_wd = reg_wdata[31:0];
 
+  assign perf_counter_spatz_enable_0_vfu_busy_0_we = addr_hit[12] & reg_we & !reg_error;
+  assign perf_counter_spatz_enable_0_vfu_busy_0_wd = reg_wdata[0];
+
+  assign perf_counter_spatz_enable_0_vfu_stall_0_we = addr_hit[12] & reg_we & !reg_error;
+  assign perf_counter_spatz_enable_0_vfu_stall_0_wd = reg_wdata[1];
+
+  assign perf_counter_spatz_enable_0_vlsu_stall_0_we = addr_hit[12] & reg_we & !reg_error;
+  assign perf_counter_spatz_enable_0_vlsu_stall_0_wd = reg_wdata[2];
+
+  assign perf_counter_spatz_enable_0_vlsu_tcdm_stall_0_we = addr_hit[12] & reg_we & !reg_error;
+  assign perf_counter_spatz_enable_0_vlsu_tcdm_stall_0_wd = reg_wdata[3];
+
+  assign perf_counter_spatz_enable_0_vsldu_busy_0_we = addr_hit[12] & reg_we & !reg_error;
+  assign perf_counter_spatz_enable_0_vsldu_busy_0_wd = reg_wdata[4];
+
+  assign perf_counter_spatz_enable_0_vrf_conflict_0_we = addr_hit[12] & reg_we & !reg_error;
+  assign perf_counter_spatz_enable_0_vrf_conflict_0_wd = reg_wdata[5];
+
+  assign perf_counter_spatz_enable_0_chaining_stall_0_we = addr_hit[12] & reg_we & !reg_error;
+  assign perf_counter_spatz_enable_0_chaining_stall_0_wd = reg_wdata[6];
+
+  assign perf_counter_spatz_enable_0_issue_full_0_we = addr_hit[12] & reg_we & !reg_error;
+  assign perf_counter_spatz_enable_0_issue_full_0_wd = reg_wdata[7];
+
+  assign perf_counter_spatz_enable_0_retired_vinsn_0_we = addr_hit[12] & reg_we & !reg_error;
+  assign perf_counter_spatz_enable_0_retired_vinsn_0_wd = reg_wdata[8];
+
+  assign perf_counter_spatz_enable_1_vfu_busy_1_we = addr_hit[13] & reg_we & !reg_error;
+  assign perf_counter_spatz_enable_1_vfu_busy_1_wd = reg_wdata[0];
+
+  assign perf_counter_spatz_enable_1_vfu_stall_1_we = addr_hit[13] & reg_we & !reg_error;
+  assign perf_counter_spatz_enable_1_vfu_stall_1_wd = reg_wdata[1];
+
+  assign perf_counter_spatz_enable_1_vlsu_stall_1_we = addr_hit[13] & reg_we & !reg_error;
+  assign perf_counter_spatz_enable_1_vlsu_stall_1_wd = reg_wdata[2];
+
+  assign perf_counter_spatz_enable_1_vlsu_tcdm_stall_1_we = addr_hit[13] & reg_we & !reg_error;
+  assign perf_counter_spatz_enable_1_vlsu_tcdm_stall_1_wd = reg_wdata[3];
+
+  assign perf_counter_spatz_enable_1_vsldu_busy_1_we = addr_hit[13] & reg_we & !reg_error;
+  assign perf_counter_spatz_enable_1_vsldu_busy_1_wd = reg_wdata[4];
+
+  assign perf_counter_spatz_enable_1_vrf_conflict_1_we = addr_hit[13] & reg_we & !reg_error;
+  assign perf_counter_spatz_enable_1_vrf_conflict_1_wd = reg_wdata[5];
+
+  assign perf_counter_spatz_enable_1_chaining_stall_1_we = addr_hit[13] & reg_we & !reg_error;
+  assign perf_counter_spatz_enable_1_chaining_stall_1_wd = reg_wdata[6];
+
+  assign perf_counter_spatz_enable_1_issue_full_1_we = addr_hit[13] & reg_we & !reg_error;
+  assign perf_counter_spatz_enable_1_issue_full_1_wd = reg_wdata[7];
+
+  assign perf_counter_spatz_enable_1_retired_vinsn_1_we = addr_hit[13] & reg_we & !reg_error;
+  assign perf_counter_spatz_enable_1_retired_vinsn_1_wd = reg_wdata[8];
+
+  assign perf_counter_hi_0_re = addr_hit[14] & reg_re & !reg_error;
+
+  assign perf_counter_hi_1_re = addr_hit[15] & reg_re & !reg_error;
+
+  assign perf_counter_freeze_we = addr_hit[16] & reg_we & !reg_error;
+  assign perf_counter_freeze_wd = reg_wdata[0];
+
   // Read data return
   always_comb begin
     reg_rdata_next = '0;
@@ -2456,11 +3106,11 @@ module spatz_cluster_peripheral_reg_top #(
       end
 
       addr_hit[4]: begin
-        reg_rdata_next[47:0] = perf_counter_0_qs;
+        reg_rdata_next[63:0] = perf_counter_0_qs;
       end
 
       addr_hit[5]: begin
-        reg_rdata_next[47:0] = perf_counter_1_qs;
+        reg_rdata_next[63:0] = perf_counter_1_qs;
       end
 
       addr_hit[6]: begin
@@ -2487,6 +3137,42 @@ module spatz_cluster_peripheral_reg_top #(
         reg_rdata_next[31:0] = cluster_boot_control_qs;
       end
 
+      addr_hit[12]: begin
+        reg_rdata_next[0] = perf_counter_spatz_enable_0_vfu_busy_0_qs;
+        reg_rdata_next[1] = perf_counter_spatz_enable_0_vfu_stall_0_qs;
+        reg_rdata_next[2] = perf_counter_spatz_enable_0_vlsu_stall_0_qs;
+        reg_rdata_next[3] = perf_counter_spatz_enable_0_vlsu_tcdm_stall_0_qs;
+        reg_rdata_next[4] = perf_counter_spatz_enable_0_vsldu_busy_0_qs;
+        reg_rdata_next[5] = perf_counter_spatz_enable_0_vrf_conflict_0_qs;
+        reg_rdata_next[6] = perf_counter_spatz_enable_0_chaining_stall_0_qs;
+        reg_rdata_next[7] = perf_counter_spatz_enable_0_issue_full_0_qs;
+        reg_rdata_next[8] = perf_counter_spatz_enable_0_retired_vinsn_0_qs;
+      end
+
+      addr_hit[13]: begin
+        reg_rdata_next[0] = perf_counter_spatz_enable_1_vfu_busy_1_qs;
+        reg_rdata_next[1] = perf_counter_spatz_enable_1_vfu_stall_1_qs;
+        reg_rdata_next[2] = perf_counter_spatz_enable_1_vlsu_stall_1_qs;
+        reg_rdata_next[3] = perf_counter_spatz_enable_1_vlsu_tcdm_stall_1_qs;
+        reg_rdata_next[4] = perf_counter_spatz_enable_1_vsldu_busy_1_qs;
+        reg_rdata_next[5] = perf_counter_spatz_enable_1_vrf_conflict_1_qs;
+        reg_rdata_next[6] = perf_counter_spatz_enable_1_chaining_stall_1_qs;
+        reg_rdata_next[7] = perf_counter_spatz_enable_1_issue_full_1_qs;
+        reg_rdata_next[8] = perf_counter_spatz_enable_1_retired_vinsn_1_qs;
+      end
+
+      addr_hit[14]: begin
+        reg_rdata_next[31:0] = perf_counter_hi_0_qs;
+      end
+
+      addr_hit[15]: begin
+        reg_rdata_next[31:0] = perf_counter_hi_1_qs;
+      end
+
+      addr_hit[16]: begin
+        reg_rdata_next[0] = perf_counter_freeze_qs;
+      end
+
       default: begin
         reg_rdata_next = '1;
       end
@@ -2509,7 +3195,7 @@ endmodule
 
 module spatz_cluster_peripheral_reg_top_intf
 #(
-  parameter int AW = 7,
+  parameter int AW = 8,
   localparam int DW = 64
 ) (
   input logic clk_i,
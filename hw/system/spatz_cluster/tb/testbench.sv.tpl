@@ -20,6 +20,8 @@ module testharness (
   import axi_pkg::xbar_rule_32_t;
 
   import "DPI-C" function int get_entry_point();
+  import "DPI-C" function void tb_boot_done();
+  import "DPI-C" function void tb_cluster_probe(input bit probe);
 
   /*********
    *  AXI  *
@@ -244,6 +246,29 @@ module testharness (
   end: vcd_dump
 `endif
 
+  // Report the kernel window, i.e., writes to SPATZ_STATUS, to the testbench
+  logic cluster_probe_q;
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      cluster_probe_q <= 1'b0;
+    end else begin
+      cluster_probe_q <= cluster_probe;
+      if (cluster_probe != cluster_probe_q) tb_cluster_probe(cluster_probe);
+    end
+  end
+
+  // Let the testbench read the performance counters of the cluster
+  export "DPI-C" function tb_num_perf_counters;
+  export "DPI-C" function tb_perf_counter;
+
+  function automatic int tb_num_perf_counters();
+    return NumPerfCounters;
+  endfunction
+
+  function automatic longint tb_perf_counter(input int idx);
+    return longint'(i_cluster_wrapper.i_cluster.i_snitch_cluster_peripheral.perf_counter_q[idx]);
+  endfunction
+
   /************************
    *  Simulation control  *
    ************************/
@@ -319,6 +344,9 @@ module testharness (
     debug_req = '1;
     @(negedge clk_i);
     debug_req = '0;
+
+    // No further wake-up events will come from the testharness
+    tb_boot_done();
   end
 
   /********
@@ -5,6 +5,7 @@
 set(SNITCH_RUNTIME "snRuntime-cluster" CACHE STRING "Target name of the snRuntime flavor to link against")
 set(SNITCH_SIMULATOR "" CACHE PATH "Command to run a binary in an RTL simulation")
 set(SIMULATOR_TIMEOUT "1800" CACHE STRING "Timeout when running tests on RTL simulation")
+set(SNITCH_BATCH_SIZE "0" CACHE STRING "Number of tests to run in one RTL simulator process (0 to disable, requires --batch support)")
 set(SPIKE_DASM "spike-dasm" CACHE PATH "Path to the spike-dasm for generating traces")
 set(LLVM_PATH "/home/spatz" CACH PATH "Path to the LLVM RISCV installation")
 set(GCC_PATH "/home/spatz" CACHE PATH "Path to the GCC RISCV installation")
@@ -53,12 +54,62 @@ macro(add_snitch_test_executable name)
 endmacro()
 
 macro(add_snitch_raw_test_rtl test_name target_name)
-  add_test(NAME ${SNITCH_TEST_PREFIX}rtl-${test_name} COMMAND ${SNITCH_SIMULATOR} $<TARGET_FILE:${target_name}>)
-  set_property(TEST ${SNITCH_TEST_PREFIX}rtl-${test_name}
-    PROPERTY LABELS ${SNITCH_TEST_PREFIX})
-  set_tests_properties(${SNITCH_TEST_PREFIX}rtl-${test_name} PROPERTIES TIMEOUT ${SIMULATOR_TIMEOUT})
-  set_tests_properties(${SNITCH_TEST_PREFIX}rtl-${test_name} PROPERTIES PASS_REGULAR_EXPRESSION "SUCCESS;PASS")
-  set_tests_properties(${SNITCH_TEST_PREFIX}rtl-${test_name} PROPERTIES FAIL_REGULAR_EXPRESSION "FAILURE")
+  if (SNITCH_BATCH_SIZE GREATER 0)
+    # The test of the binary checks its line in the results of the batch,
+    # which runs as the setup of the test's fixture
+    if (NOT DEFINED SNITCH_BATCH_INDEX)
+      set(SNITCH_BATCH_INDEX 0)
+    endif()
+    set(_snitch_batch_name ${SNITCH_TEST_PREFIX}rtl-batch-${SNITCH_BATCH_INDEX})
+    add_test(NAME ${SNITCH_TEST_PREFIX}rtl-${test_name}
+      COMMAND grep -qxF "0 $<TARGET_FILE:${target_name}>"
+        ${CMAKE_CURRENT_BINARY_DIR}/${_snitch_batch_name}.txt.results)
+    set_property(TEST ${SNITCH_TEST_PREFIX}rtl-${test_name}
+      PROPERTY LABELS ${SNITCH_TEST_PREFIX})
+    set_tests_properties(${SNITCH_TEST_PREFIX}rtl-${test_name} PROPERTIES FIXTURES_REQUIRED ${_snitch_batch_name})
+    list(APPEND SNITCH_BATCH_TARGETS ${target_name})
+    list(LENGTH SNITCH_BATCH_TARGETS _snitch_batch_length)
+    if (NOT _snitch_batch_length LESS SNITCH_BATCH_SIZE)
+      add_snitch_test_batch()
+    endif()
+  else()
+    add_test(NAME ${SNITCH_TEST_PREFIX}rtl-${test_name} COMMAND ${SNITCH_SIMULATOR} $<TARGET_FILE:${target_name}>)
+    set_property(TEST ${SNITCH_TEST_PREFIX}rtl-${test_name}
+      PROPERTY LABELS ${SNITCH_TEST_PREFIX})
+    set_tests_properties(${SNITCH_TEST_PREFIX}rtl-${test_name} PROPERTIES TIMEOUT ${SIMULATOR_TIMEOUT})
+    set_tests_properties(${SNITCH_TEST_PREFIX}rtl-${test_name} PROPERTIES PASS_REGULAR_EXPRESSION "SUCCESS;PASS")
+    set_tests_properties(${SNITCH_TEST_PREFIX}rtl-${test_name} PROPERTIES FAIL_REGULAR_EXPRESSION "FAILURE")
+  endif()
+endmacro()
+
+# Add a test which runs all binaries collected by `add_snitch_raw_test_rtl` in a
+# single simulator process. It is the fixture setup of the tests of these
+# binaries and only fails if the batch did not run through, so the binaries
+# pass or fail individually. Call this at the end of every directory adding
+# tests to flush the last, partial batch.
+macro(add_snitch_test_batch)
+  if (SNITCH_BATCH_TARGETS)
+    if (NOT DEFINED SNITCH_BATCH_INDEX)
+      set(SNITCH_BATCH_INDEX 0)
+    endif()
+    set(_snitch_batch_name ${SNITCH_TEST_PREFIX}rtl-batch-${SNITCH_BATCH_INDEX})
+    set(_snitch_batch_list ${CMAKE_CURRENT_BINARY_DIR}/${_snitch_batch_name}.txt)
+    set(_snitch_batch_content "")
+    foreach(_snitch_batch_target ${SNITCH_BATCH_TARGETS})
+      string(APPEND _snitch_batch_content "$<TARGET_FILE:${_snitch_batch_target}>\n")
+    endforeach()
+    file(GENERATE OUTPUT ${_snitch_batch_list} CONTENT "${_snitch_batch_content}")
+    list(LENGTH SNITCH_BATCH_TARGETS _snitch_batch_length)
+    math(EXPR _snitch_batch_timeout "${SIMULATOR_TIMEOUT} * ${_snitch_batch_length}")
+    add_test(NAME ${_snitch_batch_name} COMMAND ${SNITCH_SIMULATOR} --batch ${_snitch_batch_list})
+    set_property(TEST ${_snitch_batch_name}
+      PROPERTY LABELS ${SNITCH_TEST_PREFIX})
+    set_tests_properties(${_snitch_batch_name} PROPERTIES TIMEOUT ${_snitch_batch_timeout})
+    set_tests_properties(${_snitch_batch_name} PROPERTIES PASS_REGULAR_EXPRESSION "binaries passed")
+    set_tests_properties(${_snitch_batch_name} PROPERTIES FIXTURES_SETUP ${_snitch_batch_name})
+    math(EXPR SNITCH_BATCH_INDEX "${SNITCH_BATCH_INDEX} + 1")
+    set(SNITCH_BATCH_TARGETS "")
+  endif()
 endmacro()
 
 macro(add_snitch_test_rtl name)
@@ -38,6 +38,12 @@ typedef struct ident {
                           of line numbers that delimit the construct. */
 } ident_t;
 
+/*!
+ * Lock word the compiler passes to the reduction entry points. Identical to
+ * the one in the kmp.h file.
+ */
+typedef kmp_int32 kmp_critical_name[8];
+
 /*!
  @ingroup WORK_SHARING
  * Describes the loop schedule to be used for a parallel for loop.
@@ -56,15 +56,41 @@
 // types
 //================================================================================
 
+/**
+ * @brief Number of dynamically scheduled loops the threads of a team can be
+ * apart, e.g., in back-to-back loops with `nowait`
+ */
+#define OMP_LOOP_SLOTS 4
+
+/**
+ * @brief Shared state of a dynamically scheduled loop. The bounds of the loop
+ * are known to every thread, only the iterations handed out are shared.
+ */
+typedef struct {
+    // Epoch of the loop the slot serves
+    int epoch;
+    // Next iteration to hand out, counted from the lower bound
+    uint32_t next;
+    // Number of threads that ran out of iterations
+    uint32_t left;
+} omp_loop_t;
+
+/**
+ * @brief A thread's place in the tree that combines the private copies of a
+ * reduction
+ */
+typedef struct {
+    // Private copies of the thread, as passed to `__kmpc_reduce`
+    void *volatile data;
+    // Set by the thread once `data` holds the result of its subtree, cleared
+    // by its parent once it combined them
+    volatile uint32_t full;
+} omp_reduce_slot_t;
+
 typedef struct {
     char nbThreads;
 #ifndef OMPSTATIC_NUMTHREADS
-    int loop_epoch;
-    int loop_start;
-    int loop_end;
-    int loop_incr;
-    int loop_chunk;
-    int loop_is_setup;
+    omp_loop_t loops[OMP_LOOP_SLOTS];
     int core_epoch[16];  // for dynamic scheduling
 #endif
 } omp_team_t;
@@ -85,6 +111,10 @@ typedef struct {
      *
      */
     struct snrt_barrier *kmpc_barrier;
+    /**
+     * @brief Reduction slots of the threads in TCDM, see `__kmpc_reduce`
+     */
+    omp_reduce_slot_t *kmpc_reduce;
     /**
      * @brief Usually the arguments passed to __kmpc_fork_call would do a malloc
      * with the amount of arguments passed. This is too slow for our case and
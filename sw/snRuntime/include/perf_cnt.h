@@ -11,20 +11,6 @@
 enum snrt_perf_cnt {
     SNRT_PERF_CNT0,
     SNRT_PERF_CNT1,
-    SNRT_PERF_CNT2,
-    SNRT_PERF_CNT3,
-    SNRT_PERF_CNT4,
-    SNRT_PERF_CNT5,
-    SNRT_PERF_CNT6,
-    SNRT_PERF_CNT7,
-    SNRT_PERF_CNT8,
-    SNRT_PERF_CNT9,
-    SNRT_PERF_CNT10,
-    SNRT_PERF_CNT11,
-    SNRT_PERF_CNT12,
-    SNRT_PERF_CNT13,
-    SNRT_PERF_CNT14,
-    SNRT_PERF_CNT15,
     SNRT_PERF_N_CNT,
 };
 
@@ -61,21 +47,57 @@ enum snrt_perf_cnt_type {
     SNRT_PERF_CNT_ICACHE_PREFETCH,
     SNRT_PERF_CNT_ICACHE_DOUBLE_HIT,
     SNRT_PERF_CNT_ICACHE_STALL,
+    // Spatz events, enabled in `PERF_COUNTER_SPATZ_ENABLE`
+    SNRT_PERF_CNT_SPATZ_VFU_BUSY = 32,
+    SNRT_PERF_CNT_SPATZ_VFU_STALL,
+    SNRT_PERF_CNT_SPATZ_VLSU_STALL,
+    SNRT_PERF_CNT_SPATZ_VLSU_TCDM_STALL,
+    SNRT_PERF_CNT_SPATZ_VSLDU_BUSY,
+    SNRT_PERF_CNT_SPATZ_VRF_CONFLICT,
+    SNRT_PERF_CNT_SPATZ_CHAINING_STALL,
+    SNRT_PERF_CNT_SPATZ_ISSUE_FULL,
+    SNRT_PERF_CNT_SPATZ_RETIRED_VINSN,
 };
 
 typedef union {
     uint32_t value __attribute__((aligned(8)));
 } perf_reg32_t;
 
+// Register map of `spatz_cluster_peripheral`, starting at
+// `PERF_COUNTER_ENABLE_0`. The cores can only access the lower 32 bits of each
+// 64-bit register.
 typedef struct {
     volatile perf_reg32_t enable[SNRT_PERF_N_CNT];
     volatile perf_reg32_t hart_select[SNRT_PERF_N_CNT];
     volatile perf_reg32_t perf_counter[SNRT_PERF_N_CNT];
+    volatile perf_reg32_t reserved[6];
+    volatile perf_reg32_t spatz_enable[SNRT_PERF_N_CNT];
+    volatile perf_reg32_t perf_counter_hi[SNRT_PERF_N_CNT];
+    volatile perf_reg32_t freeze;
 } perf_reg_t;
 
+/// A group of performance counters which are configured, started and stopped
+/// together. Counter `i` counts event `type[i]` of hart `hart_id[i]`.
+struct snrt_perf_group {
+    uint32_t num;
+    enum snrt_perf_cnt_type type[SNRT_PERF_N_CNT];
+    uint32_t hart_id[SNRT_PERF_N_CNT];
+};
+
+/// Values of a group of performance counters, all taken in the same cycle.
+struct snrt_perf_snapshot {
+    uint64_t value[SNRT_PERF_N_CNT];
+};
+
 void snrt_start_perf_counter(enum snrt_perf_cnt perf_cnt,
                              enum snrt_perf_cnt_type perf_cnt_type,
                              uint32_t hart_id);
 void snrt_stop_perf_counter(enum snrt_perf_cnt perf_cnt);
 void snrt_reset_perf_counter(enum snrt_perf_cnt);
 uint32_t snrt_get_perf_counter(enum snrt_perf_cnt perf_cnt);
+
+void snrt_perf_group_start(const struct snrt_perf_group *group);
+void snrt_perf_group_stop(const struct snrt_perf_group *group);
+void snrt_perf_group_read(const struct snrt_perf_group *group,
+                          struct snrt_perf_snapshot *snapshot);
+const char *snrt_perf_cnt_type_name(enum snrt_perf_cnt_type perf_cnt_type);
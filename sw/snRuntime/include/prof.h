@@ -0,0 +1,94 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Scoped region profiler. Code between `snrt_prof_region_begin(id)` and
+// `snrt_prof_region_end(id)` is accounted to region `id` of the calling hart.
+// Each hart accumulates its regions in a table in the TCDM, or in the L3 if
+// the TCDM is full, which it allocates in its first `snrt_prof_region_begin`
+// or in `snrt_prof_init`. Only a pointer to the table is thread-local, so the
+// profiler takes no space from the stacks. The table is never freed; allocate
+// it before opening an L1 frame with `snrt_l1_mark`, whose release would
+// otherwise free it. Region ids of `SNRT_PROF_MAX_REGIONS` or above are
+// ignored.
+//
+// If any hart used the profiler, the runtime prints one line per hart and
+// used region through the putc buffer after `main` returned:
+//   [prof] hart=<hartid> region=<id> count=<n> cycles=<c> instret=<i>
+// followed by ` perf<k>=<v>` for each performance counter if the counter
+// deltas are sampled, see `snrt_prof_sample_perf`.
+
+#pragma once
+
+#include "perf_cnt.h"
+#include "snrt.h"
+
+/// Number of regions per hart
+#ifndef SNRT_PROF_MAX_REGIONS
+#define SNRT_PROF_MAX_REGIONS 4
+#endif
+
+struct snrt_prof_region {
+    uint32_t count;
+    uint32_t cycle_start;
+    uint32_t instret_start;
+    uint32_t perf_start[SNRT_PERF_N_CNT];
+    uint64_t cycles;
+    uint64_t instret;
+    uint64_t perf[SNRT_PERF_N_CNT];
+};
+
+extern __thread struct snrt_prof_region *_snrt_prof_regions;
+extern __thread uint32_t _snrt_prof_perf;
+
+/// Allocate the region table of the calling hart, if it has none yet. Call it
+/// before a timed section, which otherwise pays for the allocation in its
+/// first region. Returns the table, or 0 if both the TCDM and the L3 are
+/// exhausted.
+struct snrt_prof_region *snrt_prof_init();
+
+static inline struct snrt_prof_region *_snrt_prof_region(uint32_t id) {
+    if (id >= SNRT_PROF_MAX_REGIONS) return 0;
+    struct snrt_prof_region *regions = _snrt_prof_regions;
+    if (!regions && !(regions = snrt_prof_init())) return 0;
+    return &regions[id];
+}
+
+/// Also accumulate the deltas of the lower 32 bits of the performance
+/// counters for the regions of the calling hart. The counters are configured
+/// separately, e.g., with `snrt_perf_group_start`.
+static inline void snrt_prof_sample_perf(uint32_t enable) {
+    _snrt_prof_perf = enable;
+}
+
+static inline void _snrt_prof_read_perf(uint32_t *perf) {
+    perf_reg_t *perf_reg = (void *)snrt_peripherals()->perf_counters;
+    for (uint32_t i = 0; i < SNRT_PERF_N_CNT; i++)
+        perf[i] = perf_reg->perf_counter[i].value;
+}
+
+static inline void snrt_prof_region_begin(uint32_t id) {
+    struct snrt_prof_region *region = _snrt_prof_region(id);
+    if (!region) return;
+    if (_snrt_prof_perf) _snrt_prof_read_perf(region->perf_start);
+    region->instret_start = read_csr(minstret);
+    region->cycle_start = read_csr(mcycle);
+}
+
+static inline void snrt_prof_region_end(uint32_t id) {
+    uint32_t cycle = read_csr(mcycle);
+    uint32_t instret = read_csr(minstret);
+    struct snrt_prof_region *region = _snrt_prof_region(id);
+    if (!region) return;
+    region->cycles += cycle - region->cycle_start;
+    region->instret += instret - region->instret_start;
+    region->count++;
+    if (_snrt_prof_perf) {
+        uint32_t perf[SNRT_PERF_N_CNT];
+        _snrt_prof_read_perf(perf);
+        for (uint32_t i = 0; i < SNRT_PERF_N_CNT; i++)
+            region->perf[i] += perf[i] - region->perf_start[i];
+    }
+}
+
+void snrt_prof_report();
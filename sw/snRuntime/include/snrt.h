@@ -31,11 +31,15 @@ extern "C" {
 #define snrt_max(a, b) ((a) > (b) ? (a) : (b))
 #endif
 
-inline static void *snrt_memset(void *ptr, int value, size_t num) {
-    for (uint32_t i = 0; i < num; ++i)
-        *((uint8_t *)ptr + i) = (unsigned char)value;
-    return ptr;
-}
+// Copies and fills of at least this many bytes in the TCDM use the vector unit
+#ifndef SNRT_MEMCPY_VECTOR_MIN
+#define SNRT_MEMCPY_VECTOR_MIN 64
+#endif
+
+// Copies of at least this many bytes use the DMA, if the core has access to it
+#ifndef SNRT_MEMCPY_DMA_MIN
+#define SNRT_MEMCPY_DMA_MIN 1024
+#endif
 
 /// A slice of memory.
 typedef struct snrt_slice {
@@ -66,6 +70,8 @@ extern void snrt_cluster_hw_barrier();
 extern void snrt_cluster_sw_barrier();
 extern void snrt_global_barrier();
 extern void snrt_barrier(struct snrt_barrier *barr, uint32_t n);
+extern double snrt_cluster_reduce_sum_f64(double value);
+extern float snrt_cluster_reduce_sum_f32(float value);
 
 static inline uint32_t __attribute__((pure)) snrt_hartid();
 struct snrt_team_root *snrt_current_team();
@@ -101,7 +107,17 @@ extern snrt_slice_t snrt_cluster_memory();
 extern void snrt_bcast_send(void *data, size_t len);
 extern void snrt_bcast_recv(void *data, size_t len);
 
+/// Copies and fills. `snrt_memcpy`, `snrt_memset` and their `_vector` variants
+/// may use the vector unit and then clobber v0-v7, vl and vtype, so they must
+/// not be called with live vector state. The `memcpy` the compiler emits calls
+/// never uses the vector unit.
 extern void *snrt_memcpy(void *dst, const void *src, size_t n);
+extern void *snrt_memcpy_scalar(void *dst, const void *src, size_t n);
+extern void *snrt_memcpy_vector(void *dst, const void *src, size_t n);
+extern void *snrt_memcpy_dma(void *dst, const void *src, size_t n);
+extern void *snrt_memset(void *ptr, int value, size_t num);
+extern void *snrt_memset_scalar(void *ptr, int value, size_t num);
+extern void *snrt_memset_vector(void *ptr, int value, size_t num);
 
 /// DMA runtime functions.
 /// A DMA transfer identifier.
@@ -150,9 +166,52 @@ static inline uint32_t __attribute__((pure)) snrt_hartid() {
 //================================================================================
 // Allocation functions
 //================================================================================
-extern void snrt_alloc_init(struct snrt_team_root *team, uint32_t l3off);
+
+// Vector length of Spatz in bits
+#ifndef SNRT_VLEN
+#define SNRT_VLEN 512
+#endif
+
+// Number of TCDM banks and their width in bytes
+#ifndef SNRT_TCDM_BANKS
+#define SNRT_TCDM_BANKS 16
+#endif
+#ifndef SNRT_TCDM_BANK_WIDTH
+#define SNRT_TCDM_BANK_WIDTH 8
+#endif
+
+/// Alignment of a chunk to a full vector register
+#define SNRT_L1_ALIGN_VLEN (SNRT_VLEN / 8)
+/// Alignment of a chunk to the first bank of the TCDM
+#define SNRT_L1_ALIGN_BANKS (SNRT_TCDM_BANKS * SNRT_TCDM_BANK_WIDTH)
+
+// Banks between the starts of concurrent streams, by default the number of
+// banks a VLSU accesses per cycle
+#ifndef SNRT_L1_STAGGER_BANKS
+#define SNRT_L1_STAGGER_BANKS 4
+#endif
+
+/// Offset in bytes that skews stream `i` against the other streams
+#define SNRT_L1_STAGGER(i) \
+    ((i) * SNRT_L1_STAGGER_BANKS * SNRT_TCDM_BANK_WIDTH)
+
+/// A frame of L1 allocations, see `snrt_l1_mark`.
+typedef struct snrt_l1_mark {
+    uint32_t next;
+    uint32_t frame;
+} snrt_l1_mark_t;
+
+extern void snrt_alloc_init(struct snrt_team_root *team, void *l1_end,
+                            uint32_t l3off);
 extern void *snrt_l1alloc(size_t size);
+extern void *snrt_l1alloc_aligned(size_t size, size_t align);
+extern void *snrt_l1alloc_bank(size_t size, uint32_t bank);
+extern void *snrt_l1alloc_staggered(size_t size, uint32_t stream);
+extern void snrt_l1free(void *ptr);
+extern snrt_l1_mark_t snrt_l1_mark();
+extern void snrt_l1_release(snrt_l1_mark_t mark);
 extern void *snrt_l3alloc(size_t size);
+extern void *snrt_l3alloc_aligned(size_t size, size_t align);
 
 //================================================================================
 // Interrupt functions
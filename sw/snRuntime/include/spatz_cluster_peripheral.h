@@ -116,7 +116,7 @@ extern "C" {
 
 // Performance counter. Set corresponding PERF_COUNTER_ENABLE bits depending
 // on what
-#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_PERF_COUNTER_FIELD_WIDTH 48
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_PERF_COUNTER_FIELD_WIDTH 64
 #define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_PERF_COUNTER_FIELDS_PER_REG 1
 #define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_MULTIREG_COUNT 2
 
@@ -124,7 +124,7 @@ extern "C" {
 // on what
 #define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_0_REG_OFFSET 0x20
 #define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_0_PERF_COUNTER_0_MASK            \
-  0xffffffffffff
+  0xffffffffffffffff
 #define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_0_PERF_COUNTER_0_OFFSET 0
 #define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_0_PERF_COUNTER_0_FIELD           \
   ((bitfield_field32_t){                                                       \
@@ -135,7 +135,7 @@ extern "C" {
 // on what
 #define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_1_REG_OFFSET 0x28
 #define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_1_PERF_COUNTER_1_MASK            \
-  0xffffffffffff
+  0xffffffffffffffff
 #define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_1_PERF_COUNTER_1_OFFSET 0
 #define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_1_PERF_COUNTER_1_FIELD           \
   ((bitfield_field32_t){                                                       \
@@ -192,6 +192,77 @@ extern "C" {
       .index =                                                                 \
           SPATZ_CLUSTER_PERIPHERAL_CLUSTER_BOOT_CONTROL_ENTRY_POINT_OFFSET})
 
+// Enable particular Spatz performance counter events. (common parameters)
+// Enable particular Spatz performance counter events.
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_SPATZ_ENABLE_0_REG_OFFSET 0x60
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_SPATZ_ENABLE_0_VFU_BUSY_0_BIT 0
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_SPATZ_ENABLE_0_VFU_STALL_0_BIT 1
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_SPATZ_ENABLE_0_VLSU_STALL_0_BIT 2
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_SPATZ_ENABLE_0_VLSU_TCDM_STALL_0_BIT \
+  3
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_SPATZ_ENABLE_0_VSLDU_BUSY_0_BIT 4
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_SPATZ_ENABLE_0_VRF_CONFLICT_0_BIT \
+  5
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_SPATZ_ENABLE_0_CHAINING_STALL_0_BIT \
+  6
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_SPATZ_ENABLE_0_ISSUE_FULL_0_BIT 7
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_SPATZ_ENABLE_0_RETIRED_VINSN_0_BIT \
+  8
+
+// Enable particular Spatz performance counter events.
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_SPATZ_ENABLE_1_REG_OFFSET 0x68
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_SPATZ_ENABLE_1_VFU_BUSY_1_BIT 0
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_SPATZ_ENABLE_1_VFU_STALL_1_BIT 1
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_SPATZ_ENABLE_1_VLSU_STALL_1_BIT 2
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_SPATZ_ENABLE_1_VLSU_TCDM_STALL_1_BIT \
+  3
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_SPATZ_ENABLE_1_VSLDU_BUSY_1_BIT 4
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_SPATZ_ENABLE_1_VRF_CONFLICT_1_BIT \
+  5
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_SPATZ_ENABLE_1_CHAINING_STALL_1_BIT \
+  6
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_SPATZ_ENABLE_1_ISSUE_FULL_1_BIT 7
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_SPATZ_ENABLE_1_RETIRED_VINSN_1_BIT \
+  8
+
+// Upper 32 bits of the performance counter. Set PERF_COUNTER_FREEZE while
+// reading
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_HI_PERF_COUNTER_HI_FIELD_WIDTH 32
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_HI_PERF_COUNTER_HI_FIELDS_PER_REG \
+  2
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_HI_MULTIREG_COUNT 2
+
+// Upper 32 bits of the performance counter. Set PERF_COUNTER_FREEZE while
+// reading
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_HI_0_REG_OFFSET 0x70
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_HI_0_PERF_COUNTER_HI_0_MASK      \
+  0xffffffff
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_HI_0_PERF_COUNTER_HI_0_OFFSET 0
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_HI_0_PERF_COUNTER_HI_0_FIELD     \
+  ((bitfield_field32_t){                                                       \
+      .mask =                                                                  \
+          SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_HI_0_PERF_COUNTER_HI_0_MASK,   \
+      .index =                                                                 \
+          SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_HI_0_PERF_COUNTER_HI_0_OFFSET})
+
+// Upper 32 bits of the performance counter. Set PERF_COUNTER_FREEZE while
+// reading
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_HI_1_REG_OFFSET 0x78
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_HI_1_PERF_COUNTER_HI_1_MASK      \
+  0xffffffff
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_HI_1_PERF_COUNTER_HI_1_OFFSET 0
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_HI_1_PERF_COUNTER_HI_1_FIELD     \
+  ((bitfield_field32_t){                                                       \
+      .mask =                                                                  \
+          SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_HI_1_PERF_COUNTER_HI_1_MASK,   \
+      .index =                                                                 \
+          SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_HI_1_PERF_COUNTER_HI_1_OFFSET})
+
+// Freezes all performance counters. While set, no counter is incremented,
+// so the
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_FREEZE_REG_OFFSET 0x80
+#define SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_FREEZE_PERF_COUNTER_FREEZE_BIT 0
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
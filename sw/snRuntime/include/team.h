@@ -21,9 +21,28 @@ struct snrt_allocator_inst {
     // Address of the next allocated block
     uint32_t next;
 };
+// Number of size classes of the free lists of the L1 heap. Class `i` holds the
+// free blocks of at least `16 << i` bytes.
+#define SNRT_L1_NUM_CLASSES 14
+
 struct snrt_allocator {
     struct snrt_allocator_inst l1;
     struct snrt_allocator_inst l3;
+    // Heads of the free lists of the L1 heap per size class
+    uint32_t l1_free[SNRT_L1_NUM_CLASSES];
+    // The L1 heap is not freed below this address, see `snrt_l1_mark`
+    uint32_t l1_frame;
+    // Serializes the L1 allocations of the cores of the cluster
+    volatile uint32_t l1_lock;
+};
+
+// Number of cores `snrt_cluster_reduce_sum_*` can combine
+#define SNRT_REDUCE_MAX_CORES 16
+
+// Partial result of a core in a cluster reduction
+union snrt_reduce_slot {
+    double f64;
+    float f32;
 };
 
 // This struct is placed at the end of each clusters TCDM
@@ -40,6 +59,9 @@ struct snrt_team_root {
     snrt_slice_t cluster_mem;
     struct snrt_allocator allocator;
     struct snrt_barrier cluster_barrier;
+    // Partial results of the cluster reductions. Consecutive reductions
+    // alternate between the two sets, so they need no barrier in between.
+    union snrt_reduce_slot reduce[2][SNRT_REDUCE_MAX_CORES];
     uint32_t barrier_reg_ptr;
     struct snrt_peripherals peripherals;
 };
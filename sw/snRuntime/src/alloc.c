@@ -10,19 +10,270 @@
 
 #define MIN_CHUNK_SIZE 8
 
+// Smallest remainder of a reused free block that is split off as a new block
+#define MIN_SPLIT_SIZE 64
+
+/// Header in front of every block handed out by the L1 heap.
+struct l1_header {
+    // Start of the block, which precedes the header if the block was aligned
+    uint32_t start;
+    // Size of the block in bytes, starting at `start`
+    uint32_t size;
+};
+
+/// A free block of the L1 heap, placed at its start.
+struct l1_free_block {
+    uint32_t next;
+    uint32_t size;
+};
+
+static inline uint32_t l1_class(uint32_t size) {
+    uint32_t cls = 31 - __builtin_clz(size) - 4;
+    return size < 16 ? 0 : snrt_min(cls, SNRT_L1_NUM_CLASSES - 1);
+}
+
+static void l1_push(struct snrt_allocator *alloc, uint32_t start,
+                    uint32_t size) {
+    struct l1_free_block *block = (struct l1_free_block *)start;
+    uint32_t cls = l1_class(size);
+    block->next = alloc->l1_free[cls];
+    block->size = size;
+    alloc->l1_free[cls] = start;
+}
+
+/// Take a free block of at least `size` bytes out of the free lists. Blocks
+/// below the current frame are not reused, such that `snrt_l1_release` frees
+/// all chunks allocated within the frame.
+static uint32_t l1_take(struct snrt_allocator *alloc, uint32_t size,
+                        uint32_t *block_size) {
+    // The blocks of the class of the request may be too small, the blocks of
+    // the larger classes fit.
+    for (uint32_t cls = l1_class(size); cls < SNRT_L1_NUM_CLASSES; cls++) {
+        for (uint32_t *prev = &alloc->l1_free[cls]; *prev;
+             prev = &((struct l1_free_block *)*prev)->next) {
+            struct l1_free_block *block = (struct l1_free_block *)*prev;
+            if (block->size >= size && *prev >= alloc->l1_frame) {
+                *prev = block->next;
+                *block_size = block->size;
+                return (uint32_t)block;
+            }
+        }
+    }
+    return 0;
+}
+
+/// Drop the free blocks at or above `end` from the free lists.
+static void l1_drop(struct snrt_allocator *alloc, uint32_t end) {
+    for (uint32_t cls = 0; cls < SNRT_L1_NUM_CLASSES; cls++) {
+        uint32_t *prev = &alloc->l1_free[cls];
+        while (*prev) {
+            struct l1_free_block *block = (struct l1_free_block *)*prev;
+            if ((uint32_t)block >= end)
+                *prev = block->next;
+            else
+                prev = &block->next;
+        }
+    }
+}
+
+/// Return the free blocks at the top of the heap to the unallocated region.
+static void l1_trim(struct snrt_allocator *alloc) {
+    for (int trimmed = 1; trimmed;) {
+        trimmed = 0;
+        for (uint32_t cls = 0; cls < SNRT_L1_NUM_CLASSES && !trimmed; cls++) {
+            for (uint32_t *prev = &alloc->l1_free[cls]; *prev;
+                 prev = &((struct l1_free_block *)*prev)->next) {
+                struct l1_free_block *block = (struct l1_free_block *)*prev;
+                uint32_t start = (uint32_t)block;
+                if (start + block->size == alloc->l1.next &&
+                    start >= alloc->l1_frame) {
+                    *prev = block->next;
+                    alloc->l1.next = start;
+                    trimmed = 1;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/// Allocate a chunk of `size` bytes that starts `offset` bytes behind an
+/// `align` boundary.
+static void *l1_alloc(size_t size, size_t align, size_t offset) {
+    struct snrt_allocator *alloc = &snrt_current_team()->allocator;
+
+    align = snrt_max(align, MIN_CHUNK_SIZE);
+    size = ALIGN_UP(size, MIN_CHUNK_SIZE);
+    offset = ALIGN_UP(offset, MIN_CHUNK_SIZE) & (align - 1);
+    // Worst case size of a block holding the header and the aligned chunk
+    uint32_t need = sizeof(struct l1_header) + size + align - MIN_CHUNK_SIZE;
+
+    snrt_mutex_lock(&alloc->l1_lock);
+
+    uint32_t block_size;
+    uint32_t start = l1_take(alloc, need, &block_size);
+    uint32_t chunk, end;
+    if (start) {
+        chunk = ALIGN_UP(start + sizeof(struct l1_header) - offset, align) +
+                offset;
+        end = chunk + size;
+        if (start + block_size - end >= MIN_SPLIT_SIZE) {
+            l1_push(alloc, end, start + block_size - end);
+            block_size = end - start;
+        }
+    } else {
+        start = alloc->l1.next;
+        chunk = ALIGN_UP(start + sizeof(struct l1_header) - offset, align) +
+                offset;
+        end = chunk + size;
+        if (end < start || end > alloc->l1.base + alloc->l1.size) {
+            snrt_mutex_release(&alloc->l1_lock);
+            snrt_trace(SNRT_TRACE_ALLOC,
+                       "Not enough memory to allocate: base %#x size %#x next "
+                       "%#x\n",
+                       alloc->l1.base, alloc->l1.size, alloc->l1.next);
+            return 0;
+        }
+        alloc->l1.next = end;
+        block_size = end - start;
+    }
+
+    struct l1_header *header =
+        (struct l1_header *)(chunk - sizeof(struct l1_header));
+    header->start = start;
+    header->size = block_size;
+
+    snrt_mutex_release(&alloc->l1_lock);
+    return (void *)chunk;
+}
+
+/**
+ * @brief Allocate an aligned chunk of memory in the L1 memory
+ * @details The chunk is reused from a freed chunk if one is large enough,
+ * otherwise it is taken from the unallocated part of the TCDM. Can be called
+ * by all cores of the cluster.
+ *
+ * @param size number of bytes to allocate
+ * @param align alignment of the chunk, a power of two, e.g.,
+ * `SNRT_L1_ALIGN_VLEN` or `SNRT_L1_ALIGN_BANKS`
+ * @return pointer to the allocated memory, or 0 if the TCDM is full
+ */
+void *snrt_l1alloc_aligned(size_t size, size_t align) {
+    return l1_alloc(size, align, 0);
+}
+
+/**
+ * @brief Allocate a chunk of memory in the L1 memory that starts in a bank
+ * @details Buffers that are streamed concurrently, e.g., by different cores
+ * or by the ports of a VLSU, conflict in the TCDM if they start in the same
+ * bank and are accessed at the same offsets.
+ *
+ * @param size number of bytes to allocate
+ * @param bank TCDM bank the chunk starts in
+ * @return pointer to the allocated memory, or 0 if the TCDM is full
+ */
+void *snrt_l1alloc_bank(size_t size, uint32_t bank) {
+    return l1_alloc(size, SNRT_L1_ALIGN_BANKS,
+                    (bank % SNRT_TCDM_BANKS) * SNRT_TCDM_BANK_WIDTH);
+}
+
+/**
+ * @brief Allocate the chunk of memory of a stream in the L1 memory
+ * @details Stream `i` starts `SNRT_L1_STAGGER(i)` bytes behind a bank
+ * boundary, such that the chunks of concurrently accessed streams, e.g.,
+ * the operands of a kernel, start in different banks.
+ *
+ * @param size number of bytes to allocate
+ * @param stream index of the stream
+ * @return pointer to the allocated memory, or 0 if the TCDM is full
+ */
+void *snrt_l1alloc_staggered(size_t size, uint32_t stream) {
+    return l1_alloc(size, SNRT_L1_ALIGN_BANKS,
+                    SNRT_L1_STAGGER(stream) % SNRT_L1_ALIGN_BANKS);
+}
+
 /**
  * @brief Allocate a chunk of memory in the L1 memory
- * @details This currently does not support free-ing of memory
  *
  * @param size number of bytes to allocate
- * @return pointer to the allocated memory
+ * @return pointer to the allocated memory, or 0 if the TCDM is full
  */
 void *snrt_l1alloc(size_t size) {
-    struct snrt_allocator_inst *alloc = &snrt_current_team()->allocator.l1;
+    return l1_alloc(size, MIN_CHUNK_SIZE, 0);
+}
 
+/**
+ * @brief Free a chunk allocated by one of the `snrt_l1alloc` functions
+ * @details The chunk is put on the free list of its size class. Freed chunks
+ * are not merged with their neighbors, except at the top of the heap, which
+ * shrinks again.
+ *
+ * @param ptr pointer to the chunk, may be 0
+ */
+void snrt_l1free(void *ptr) {
+    if (!ptr) return;
+    struct snrt_allocator *alloc = &snrt_current_team()->allocator;
+    struct l1_header *header =
+        (struct l1_header *)((uint32_t)ptr - sizeof(struct l1_header));
+    uint32_t start = header->start;
+    uint32_t size = header->size;
+
+    snrt_mutex_lock(&alloc->l1_lock);
+    l1_push(alloc, start, size);
+    l1_trim(alloc);
+    snrt_mutex_release(&alloc->l1_lock);
+}
+
+/**
+ * @brief Open a frame of L1 allocations
+ * @details All chunks allocated after the mark are freed at once by passing
+ * it to `snrt_l1_release`, e.g., the scratch buffers of a layer. Chunks
+ * allocated before the mark stay valid and can still be freed individually,
+ * but their memory is only reused after the frame is released.
+ * Frames can be nested, but have to be released in reverse order.
+ *
+ * @return the mark to pass to `snrt_l1_release`
+ */
+snrt_l1_mark_t snrt_l1_mark() {
+    struct snrt_allocator *alloc = &snrt_current_team()->allocator;
+    snrt_mutex_lock(&alloc->l1_lock);
+    snrt_l1_mark_t mark = {alloc->l1.next, alloc->l1_frame};
+    alloc->l1_frame = alloc->l1.next;
+    snrt_mutex_release(&alloc->l1_lock);
+    return mark;
+}
+
+/**
+ * @brief Free all chunks allocated since `mark`
+ *
+ * @param mark returned by the matching `snrt_l1_mark`
+ */
+void snrt_l1_release(snrt_l1_mark_t mark) {
+    struct snrt_allocator *alloc = &snrt_current_team()->allocator;
+    snrt_mutex_lock(&alloc->l1_lock);
+    l1_drop(alloc, mark.next);
+    alloc->l1.next = mark.next;
+    alloc->l1_frame = mark.frame;
+    l1_trim(alloc);
+    snrt_mutex_release(&alloc->l1_lock);
+}
+
+/**
+ * @brief Allocate an aligned chunk of memory in the L3 memory
+ * @details This currently does not support free-ing of memory
+ *
+ * @param size number of bytes to allocate
+ * @param align alignment of the chunk, a power of two
+ * @return pointer to the allocated memory, or 0 if the L3 is full
+ */
+void *snrt_l3alloc_aligned(size_t size, size_t align) {
+    struct snrt_allocator_inst *alloc = &snrt_current_team()->allocator.l3;
+
+    align = snrt_max(align, MIN_CHUNK_SIZE);
     size = ALIGN_UP(size, MIN_CHUNK_SIZE);
 
-    if (alloc->next + size > alloc->base + alloc->size) {
+    uint32_t ret = ALIGN_UP(alloc->next, align);
+    if (ret < alloc->next || alloc->base + alloc->size - ret < size) {
         snrt_trace(
             SNRT_TRACE_ALLOC,
             "Not enough memory to allocate: base %#x size %#x next %#x\n",
@@ -30,9 +281,8 @@ void *snrt_l1alloc(size_t size) {
         return 0;
     }
 
-    void *ret = (void *)alloc->next;
-    alloc->next += size;
-    return ret;
+    alloc->next = ret + size;
+    return (void *)ret;
 }
 
 /**
@@ -40,16 +290,10 @@ void *snrt_l1alloc(size_t size) {
  * @details This currently does not support free-ing of memory
  *
  * @param size number of bytes to allocate
- * @return pointer to the allocated memory
+ * @return pointer to the allocated memory, or 0 if the L3 is full
  */
 void *snrt_l3alloc(size_t size) {
-    struct snrt_allocator_inst *alloc = &snrt_current_team()->allocator.l3;
-
-    // TODO: L3 alloc size check
-
-    void *ret = (void *)alloc->next;
-    alloc->next += size;
-    return ret;
+    return snrt_l3alloc_aligned(size, MIN_CHUNK_SIZE);
 }
 
 /**
@@ -57,20 +301,26 @@ void *snrt_l3alloc(size_t size) {
  * @details
  *
  * @param snrt_team_root pointer to the team structure
+ * @param l1_end End of the L1 memory available to the allocator, i.e., the
+ * bottom of the stacks
  * @param l3off Number of bytes to skip on _edram before starting allocator
  */
-void snrt_alloc_init(struct snrt_team_root *team, uint32_t l3off) {
+void snrt_alloc_init(struct snrt_team_root *team, void *l1_end,
+                     uint32_t l3off) {
     // Allocator in L1 TCDM memory
     team->allocator.l1.base =
         ALIGN_UP((uint32_t)team->cluster_mem.start, MIN_CHUNK_SIZE);
-    team->allocator.l1.size =
-        (uint32_t)(team->cluster_mem.end - team->cluster_mem.start);
+    team->allocator.l1.size = (uint32_t)l1_end - team->allocator.l1.base;
     team->allocator.l1.next = team->allocator.l1.base;
+    for (uint32_t cls = 0; cls < SNRT_L1_NUM_CLASSES; cls++)
+        team->allocator.l1_free[cls] = 0;
+    team->allocator.l1_frame = team->allocator.l1.base;
+    team->allocator.l1_lock = 0;
     // Allocator in L3 shared memory
     extern uint32_t _edram;
     team->allocator.l3.base =
-        ALIGN_UP((uint32_t)_edram + l3off, MIN_CHUNK_SIZE);
-    ;
-    team->allocator.l3.size = 0;
+        ALIGN_UP((uint32_t)&_edram + l3off, MIN_CHUNK_SIZE);
+    team->allocator.l3.size =
+        (uint32_t)(team->global_mem.end - team->allocator.l3.base);
     team->allocator.l3.next = team->allocator.l3.base;
 }
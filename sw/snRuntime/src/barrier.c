@@ -74,3 +74,60 @@ void snrt_barrier(struct snrt_barrier *barr, uint32_t n) {
             ;
     }
 }
+
+// Set of reduction slots the core uses next, see `snrt_team_root::reduce`
+static __thread uint32_t reduce_set;
+
+/**
+ * @brief Slots of the next cluster reduction
+ * @details All cores of the cluster take part in every reduction, so they
+ * agree on the set to use.
+ */
+static inline volatile union snrt_reduce_slot *snrt_reduce_slots() {
+    volatile union snrt_reduce_slot *slots =
+        _snrt_team_current->root->reduce[reduce_set];
+    reduce_set ^= 1;
+    return slots;
+}
+
+/**
+ * @brief Sum a double over all cores of the cluster
+ * @details Combines the partial results in the TCDM along a binary tree, one
+ * level per hardware barrier. Must be called by all cores of the cluster.
+ *
+ * @param value partial result of the calling core
+ * @return the sum over all cores, on every core
+ */
+double snrt_cluster_reduce_sum_f64(double value) {
+    volatile union snrt_reduce_slot *slots = snrt_reduce_slots();
+    uint32_t idx = snrt_cluster_core_idx();
+    uint32_t n = snrt_cluster_core_num();
+
+    slots[idx].f64 = value;
+    for (uint32_t s = 1; s < n; s <<= 1) {
+        snrt_cluster_hw_barrier();
+        if ((idx & (2 * s - 1)) == 0 && idx + s < n)
+            slots[idx].f64 = value += slots[idx + s].f64;
+    }
+    snrt_cluster_hw_barrier();
+    return slots[0].f64;
+}
+
+/**
+ * @brief Sum a float over all cores of the cluster
+ * @details See `snrt_cluster_reduce_sum_f64`.
+ */
+float snrt_cluster_reduce_sum_f32(float value) {
+    volatile union snrt_reduce_slot *slots = snrt_reduce_slots();
+    uint32_t idx = snrt_cluster_core_idx();
+    uint32_t n = snrt_cluster_core_num();
+
+    slots[idx].f32 = value;
+    for (uint32_t s = 1; s < n; s <<= 1) {
+        snrt_cluster_hw_barrier();
+        if ((idx & (2 * s - 1)) == 0 && idx + s < n)
+            slots[idx].f32 = value += slots[idx + s].f32;
+    }
+    snrt_cluster_hw_barrier();
+    return slots[0].f32;
+}
@@ -6,18 +6,169 @@
 
 #include "snrt.h"
 
-// TODO: Implement using cluster DMA for a faster `memcpy`.
+// This file must be compiled with `-fno-builtin`, otherwise the compiler
+// replaces the scalar loops with calls to `memcpy` and `memset`.
+
+/// Whether the `n` bytes at `ptr` lie in the TCDM of the cluster.
+static inline int snrt_in_tcdm(const void *ptr, size_t n, snrt_slice_t tcdm) {
+    uint32_t addr = (uint32_t)ptr;
+    return addr >= tcdm.start && addr + n <= tcdm.end;
+}
+
+/// Whether the calling hart can issue DMA transfers. The DMA of the Spatz
+/// cluster is attached to its first core, see the `xdma` flags of the cluster
+/// configuration.
+static inline int snrt_has_dma() { return snrt_cluster_core_idx() == 0; }
+
+/**
+ * @brief Copy with word-wide loads and stores of the core
+ * @details Falls back to byte accesses if `dst` and `src` are not aligned
+ * to each other, and for the unaligned head and tail of the copy.
+ */
+void *snrt_memcpy_scalar(void *dst, const void *src, size_t n) {
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+
+    if ((((uint32_t)d ^ (uint32_t)s) & 3) == 0) {
+        for (; n && ((uint32_t)d & 3); n--) *d++ = *s++;
+        uint32_t *dw = (uint32_t *)d;
+        const uint32_t *sw = (const uint32_t *)s;
+        for (; n >= 16; n -= 16, dw += 4, sw += 4) {
+            uint32_t w0 = sw[0], w1 = sw[1], w2 = sw[2], w3 = sw[3];
+            dw[0] = w0;
+            dw[1] = w1;
+            dw[2] = w2;
+            dw[3] = w3;
+        }
+        for (; n >= 4; n -= 4) *dw++ = *sw++;
+        d = (uint8_t *)dw;
+        s = (const uint8_t *)sw;
+    }
+    for (; n; n--) *d++ = *s++;
+
+    return dst;
+}
+
+/**
+ * @brief Copy with the vector unit of the core
+ * @details Streams the data through the register group v0-v7 with byte-wide
+ * unit-stride accesses, so `dst` and `src` need no alignment. Both buffers
+ * must be in the TCDM. Clobbers v0-v7, vl and vtype.
+ */
+void *snrt_memcpy_vector(void *dst, const void *src, size_t n) {
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+
+    for (size_t vl; n; n -= vl, d += vl, s += vl) {
+        asm volatile(
+            "vsetvli %0, %1, e8, m8, ta, ma \n"
+            "vle8.v v0, (%2) \n"
+            "vse8.v v0, (%3) \n"
+            : "=&r"(vl)
+            : "r"(n), "r"(s), "r"(d)
+            : "memory");
+    }
+
+    return dst;
+}
+
+/**
+ * @brief Copy with the cluster DMA and wait for the transfer to complete
+ * @details Can only be called by the core the DMA is attached to.
+ */
+void *snrt_memcpy_dma(void *dst, const void *src, size_t n) {
+    snrt_dma_wait(snrt_dma_start_1d(dst, src, n));
+    return dst;
+}
+
+/**
+ * @brief Copy `n` bytes from `src` to `dst`
+ * @details Copies of less than `SNRT_MEMCPY_VECTOR_MIN` bytes are done by the
+ * core. On the core with the DMA, copies that involve memory outside of the
+ * TCDM or of at least `SNRT_MEMCPY_DMA_MIN` bytes go through the DMA. The
+ * remaining copies within the TCDM use the vector unit. Copies of the other
+ * cores from or to the L3 use the core, since the vector unit can only access
+ * the TCDM.
+ */
 void *snrt_memcpy(void *dst, const void *src, size_t n) {
-    return memcpy(dst, src, n);
+    if (n < SNRT_MEMCPY_VECTOR_MIN) return snrt_memcpy_scalar(dst, src, n);
+
+    snrt_slice_t tcdm = snrt_cluster_memory();
+    int local = snrt_in_tcdm(dst, n, tcdm) && snrt_in_tcdm(src, n, tcdm);
+    if (snrt_has_dma() && (!local || n >= SNRT_MEMCPY_DMA_MIN))
+        return snrt_memcpy_dma(dst, src, n);
+    if (local) return snrt_memcpy_vector(dst, src, n);
+    return snrt_memcpy_scalar(dst, src, n);
 }
 
-void* memcpy(void *dest, const void *src, size_t n) {
-  const char *csrc = (const char *)src;
-  char *cdest = (char *)dest;
+/**
+ * @brief Copy `n` bytes from `src` to `dst`
+ * @details Called for copies the compiler emits, e.g., of structs, which can
+ * sit in the middle of a vector kernel. Therefore never uses the vector unit,
+ * only the DMA and the core, with the same thresholds as `snrt_memcpy`.
+ */
+void *memcpy(void *dest, const void *src, size_t n) {
+    if (n >= SNRT_MEMCPY_VECTOR_MIN && snrt_has_dma()) {
+        snrt_slice_t tcdm = snrt_cluster_memory();
+        if (n >= SNRT_MEMCPY_DMA_MIN || !snrt_in_tcdm(dest, n, tcdm) ||
+            !snrt_in_tcdm(src, n, tcdm))
+            return snrt_memcpy_dma(dest, src, n);
+    }
+    return snrt_memcpy_scalar(dest, src, n);
+}
+
+/**
+ * @brief Fill with word-wide stores of the core
+ */
+void *snrt_memset_scalar(void *ptr, int value, size_t num) {
+    uint8_t *d = (uint8_t *)ptr;
+    uint8_t byte = (uint8_t)value;
+
+    for (; num && ((uint32_t)d & 3); num--) *d++ = byte;
+    uint32_t word = byte * 0x01010101u;
+    uint32_t *dw = (uint32_t *)d;
+    for (; num >= 16; num -= 16, dw += 4) {
+        dw[0] = word;
+        dw[1] = word;
+        dw[2] = word;
+        dw[3] = word;
+    }
+    for (; num >= 4; num -= 4) *dw++ = word;
+    d = (uint8_t *)dw;
+    for (; num; num--) *d++ = byte;
 
-  // Copy contents of src[] to dest[]
-  for (size_t i = 0; i < n; ++i)
-    cdest[i] = csrc[i];
+    return ptr;
+}
+
+/**
+ * @brief Fill with the vector unit of the core
+ * @details The buffer must be in the TCDM. Clobbers v0-v7, vl and vtype.
+ */
+void *snrt_memset_vector(void *ptr, int value, size_t num) {
+    uint8_t *d = (uint8_t *)ptr;
+
+    for (size_t vl; num; num -= vl, d += vl) {
+        asm volatile(
+            "vsetvli %0, %1, e8, m8, ta, ma \n"
+            "vmv.v.x v0, %2 \n"
+            "vse8.v v0, (%3) \n"
+            : "=&r"(vl)
+            : "r"(num), "r"(value), "r"(d)
+            : "memory");
+    }
+
+    return ptr;
+}
 
-  return dest;
+/**
+ * @brief Fill `num` bytes at `ptr` with `value`
+ * @details Buffers of at least `SNRT_MEMCPY_VECTOR_MIN` bytes in the TCDM are
+ * filled by the vector unit, all others by the core. The DMA cannot fill
+ * memory.
+ */
+void *snrt_memset(void *ptr, int value, size_t num) {
+    if (num >= SNRT_MEMCPY_VECTOR_MIN &&
+        snrt_in_tcdm(ptr, num, snrt_cluster_memory()))
+        return snrt_memset_vector(ptr, value, num);
+    return snrt_memset_scalar(ptr, value, num);
 }
@@ -378,12 +378,172 @@ void __kmpc_for_static_init_8u(ident_t *loc, kmp_int32 gtid, kmp_int32 sched,
                *plastiter, *plower, *pupper, incr, *pstride, chunk);
 }
 
+//================================================================================
+// Reductions
+//================================================================================
+
+/**
+ * @brief Combine the private copies of a reduction along a binomial tree
+ * @details At level `s`, a thread with bit `s` set in its number hands its
+ * copies to the thread `s` below and waits until they have been combined.
+ * The others combine the copies of the thread `s` above into their own. The
+ * master ends up with the result after log2(nbThreads) levels, without a
+ * shared counter the threads contend for.
+ *
+ * @return 1 on the master, 0 on all other threads
+ */
+static kmp_int32 kmp_reduce_tree(void *reduce_data,
+                                 void (*reduce_func)(void *, void *)) {
+    _OMP_T *omp = omp_getData();
+    omp_reduce_slot_t *slots = omp->kmpc_reduce;
+    unsigned threadNum = omp_get_thread_num();
+    unsigned nbThreads = omp_get_team(omp)->nbThreads;
+
+    for (unsigned s = 1; s < nbThreads; s <<= 1) {
+        if (threadNum & s) {
+            omp_reduce_slot_t *slot = &slots[threadNum];
+            slot->data = reduce_data;
+            __atomic_store_n(&slot->full, 1, __ATOMIC_RELEASE);
+            // The copies live on the stack of this thread
+            while (__atomic_load_n(&slot->full, __ATOMIC_ACQUIRE))
+                ;
+            return 0;
+        }
+        if (threadNum + s < nbThreads) {
+            omp_reduce_slot_t *child = &slots[threadNum + s];
+            while (!__atomic_load_n(&child->full, __ATOMIC_ACQUIRE))
+                ;
+            reduce_func(reduce_data, child->data);
+            __atomic_store_n(&child->full, 0, __ATOMIC_RELEASE);
+        }
+    }
+    return 1;
+}
+
+/*!
+@ingroup SYNCHRONIZATION
+@param loc source location information
+@param global_tid global thread number
+@param num_vars number of items (variables) to be reduced
+@param reduce_size size of data in bytes to be reduced
+@param reduce_data pointer to data to be reduced
+@param reduce_func callback function providing reduction operation on two
+operands and returning result of reduction in lhs_data
+@param lck pointer to the unique lock data structure
+@result 1 for the master thread, 0 for all other team threads
+
+The master combines its private copies, which hold the result of the team,
+into the shared variables and calls @ref __kmpc_end_reduce_nowait. The
+reduction is a tree of the threads in the TCDM, the atomic method (return
+value 2) is never selected.
+*/
+kmp_int32 __kmpc_reduce_nowait(ident_t *loc, kmp_int32 global_tid,
+                               kmp_int32 num_vars, size_t reduce_size,
+                               void *reduce_data,
+                               void (*reduce_func)(void *lhs_data,
+                                                   void *rhs_data),
+                               kmp_critical_name *lck) {
+    (void)loc;
+    (void)num_vars;
+    (void)reduce_size;
+    (void)lck;
+    KMP_PRINTF(10, "__kmpc_reduce_nowait: T#%d num_vars %d\n", global_tid,
+               num_vars);
+    return kmp_reduce_tree(reduce_data, reduce_func);
+}
+
+/*!
+@ingroup SYNCHRONIZATION
+@param loc source location information
+@param global_tid global thread id.
+@param lck pointer to the unique lock data structure
+
+Finish the execution of a reduce nowait. All other threads have handed over
+their copies already, so there is nothing left to do.
+*/
+void __kmpc_end_reduce_nowait(ident_t *loc, kmp_int32 global_tid,
+                              kmp_critical_name *lck) {
+    (void)loc;
+    (void)global_tid;
+    (void)lck;
+}
+
+/*!
+@ingroup SYNCHRONIZATION
+See @ref __kmpc_reduce_nowait
+
+A blocking reduce that includes an implicit barrier. The other threads wait in
+the barrier until the master has stored the result in @ref __kmpc_end_reduce.
+*/
+kmp_int32 __kmpc_reduce(ident_t *loc, kmp_int32 global_tid, kmp_int32 num_vars,
+                        size_t reduce_size, void *reduce_data,
+                        void (*reduce_func)(void *lhs_data, void *rhs_data),
+                        kmp_critical_name *lck) {
+    (void)num_vars;
+    (void)reduce_size;
+    (void)lck;
+    KMP_PRINTF(10, "__kmpc_reduce: T#%d num_vars %d\n", global_tid, num_vars);
+    kmp_int32 ret = kmp_reduce_tree(reduce_data, reduce_func);
+    if (!ret) __kmpc_barrier(loc, global_tid);
+    return ret;
+}
+
+/*!
+@ingroup SYNCHRONIZATION
+@param loc source location information
+@param global_tid global thread id.
+@param lck pointer to the unique lock data structure
+
+Finish the execution of a blocking reduce and release the other threads.
+*/
+void __kmpc_end_reduce(ident_t *loc, kmp_int32 global_tid,
+                       kmp_critical_name *lck) {
+    (void)lck;
+    __kmpc_barrier(loc, global_tid);
+}
+
 //================================================================================
 // Dynamic scheduling
 // Only available if not OMPSTATIC_NUMTHREADS
 //================================================================================
 #ifndef OMPSTATIC_NUMTHREADS
 
+/**
+ * @brief A guided schedule hands out this fraction of the remaining iterations
+ * divided by the number of threads, but at least the chunk size
+ */
+#define KMP_GUIDED_DIVISOR 2
+
+/**
+ * @brief The dynamically scheduled loop a thread currently executes. All
+ * threads of the team enter the same loops with the same bounds, so they only
+ * share the iterations handed out so far, in the slot of the loop.
+ */
+static __thread struct {
+    omp_loop_t *slot;
+    int epoch;
+    enum sched_type sched;
+    kmp_int32 lb;
+    kmp_int32 st;
+    kmp_uint32 trip;
+    kmp_uint32 chunk;
+} kmp_loop;
+
+/**
+ * @brief Leave the current loop. The last thread to leave frees the slot for
+ * the loop `OMP_LOOP_SLOTS` epochs later.
+ */
+static void kmp_dispatch_leave(omp_team_t *team) {
+    omp_loop_t *slot = kmp_loop.slot;
+    uint32_t left = __atomic_add_fetch(&slot->left, 1, __ATOMIC_RELAXED);
+    if (left == (uint32_t)team->nbThreads) {
+        slot->next = 0;
+        slot->left = 0;
+        __atomic_store_n(&slot->epoch, kmp_loop.epoch + OMP_LOOP_SLOTS,
+                         __ATOMIC_RELEASE);
+    }
+}
+
 /*!
 @ingroup WORK_SHARING
 @{
@@ -404,32 +564,34 @@ void __kmpc_dispatch_init_4(ident_t *loc, kmp_int32 gtid,
                             kmp_int32 ub, kmp_int32 st, kmp_int32 chunk) {
     (void)loc;
     (void)gtid;
-    (void)schedule;
     omp_team_t *team = omp_get_team(omp_getData());
-    // dynLoopInitNoIter(team, lb, ub, st, chunk);
-    // int core_id = omp_get_thread_num();
-    eu_mutex_lock();
-    // if (team->loop_epoch - team->core_epoch[core_id] != 0)
-    // {
-    //   eu_mutex_release();
-    //   team->core_epoch[core_id]++;
-    //   KMP_PRINTF(10, "__kmpc_dispatch_init_4 core_epoch[%d] =
-    //   %d\n",core_id,team->core_epoch[core_id]); return;
-    // }
-
-    if (!team->loop_is_setup) {
-        team->loop_is_setup = 1;
-        team->loop_start = lb;
-        team->loop_end = ub;
-        team->loop_incr = st;
-        team->loop_chunk = chunk;
-        KMP_PRINTF(
-            10,
-            "__kmpc_dispatch_init_4 setup: start %d end %d incr %d chunk %d\n",
-            team->loop_start, team->loop_end, team->loop_incr,
-            team->loop_chunk);
-    }
-    eu_mutex_release();
+    unsigned threadNum = omp_get_thread_num();
+
+    // Every thread counts the loops it entered in this parallel region, which
+    // selects the slot of the loop.
+    int epoch = team->core_epoch[threadNum]++;
+    omp_loop_t *slot = &team->loops[epoch % OMP_LOOP_SLOTS];
+
+    kmp_loop.slot = slot;
+    kmp_loop.epoch = epoch;
+    kmp_loop.sched = SCHEDULE_WITHOUT_MODIFIERS(schedule);
+    kmp_loop.lb = lb;
+    kmp_loop.st = st;
+    if (st > 0)
+        kmp_loop.trip = ub < lb ? 0 : (kmp_uint32)(ub - lb) / st + 1;
+    else
+        kmp_loop.trip = ub > lb ? 0 : (kmp_uint32)(lb - ub) / -st + 1;
+    kmp_loop.chunk = chunk > 0 ? chunk : 1;
+
+    KMP_PRINTF(10,
+               "__kmpc_dispatch_init_4 epoch %d sched %d: lb %d ub %d st %d "
+               "chunk %d trip %d\n",
+               epoch, kmp_loop.sched, lb, ub, st, chunk, kmp_loop.trip);
+
+    // Wait for the slowest thread to leave the loop that used the slot
+    // before. Only happens if a thread is `OMP_LOOP_SLOTS` loops ahead.
+    while (__atomic_load_n(&slot->epoch, __ATOMIC_ACQUIRE) != epoch)
+        ;
 }
 
 /*!
@@ -455,6 +617,11 @@ otherwise
 
 Get the next dynamically allocated chunk of work for this thread.
 If there is no more work, then the lb,ub and stride need not be modified.
+
+A dynamic schedule claims a chunk with a single `amoadd` on the shared
+iteration counter. A guided schedule claims a fraction of the remaining
+iterations, which depends on the counter and is claimed with a
+compare-and-swap.
 */
 int __kmpc_dispatch_next_4(ident_t *loc, kmp_int32 gtid, kmp_int32 *p_last,
                            kmp_int32 *p_lb, kmp_int32 *p_ub, kmp_int32 *p_st) {
@@ -462,36 +629,42 @@ int __kmpc_dispatch_next_4(ident_t *loc, kmp_int32 gtid, kmp_int32 *p_last,
     (void)gtid;
 
     omp_team_t *team = omp_get_team(omp_getData());
-
-    // The stride is actually always 1
-    *p_st = 1;
-
-    // int result = dynLoopIter(team, (int*) p_lb, (int*) p_ub, (int*) p_last);
-    eu_mutex_lock();
+    omp_loop_t *slot = kmp_loop.slot;
+    kmp_uint32 trip = kmp_loop.trip;
+    kmp_uint32 first, size;
+
+    if (kmp_loop.sched == kmp_sch_guided_chunked ||
+        kmp_loop.sched == kmp_sch_guided_iterative_chunked ||
+        kmp_loop.sched == kmp_sch_guided_analytical_chunked) {
+        first = __atomic_load_n(&slot->next, __ATOMIC_RELAXED);
+        do {
+            if (first >= trip) break;
+            size = (trip - first) / (KMP_GUIDED_DIVISOR * team->nbThreads);
+            size = snrt_max(size, kmp_loop.chunk);
+        } while (!__atomic_compare_exchange_n(&slot->next, &first,
+                                              first + size, 1, __ATOMIC_RELAXED,
+                                              __ATOMIC_RELAXED));
+    } else {
+        size = kmp_loop.chunk;
+        first = __atomic_fetch_add(&slot->next, size, __ATOMIC_RELAXED);
+    }
 
     // have already iterated over all the iterations(no more work), return 0
-    if (team->loop_start > team->loop_end) {
-        team->loop_is_setup = 0;
-        KMP_PRINTF(
-            10, "__kmpc_dispatch_next_4 start > end: team->loop_is_setup %d\n",
-            team->loop_is_setup);
-        eu_mutex_release();
+    if (first >= trip) {
+        KMP_PRINTF(10, "__kmpc_dispatch_next_4 epoch %d done\n",
+                   kmp_loop.epoch);
+        kmp_dispatch_leave(team);
         return 0;
     }
 
-    *p_lb = team->loop_start;
-    *p_ub = *p_lb + team->loop_chunk - 1;
-    if (*p_ub >= team->loop_end) {
-        *p_ub = team->loop_end;
-        *p_last = 1;
-    }
+    size = snrt_min(size, trip - first);
+    *p_lb = kmp_loop.lb + (kmp_int32)first * kmp_loop.st;
+    *p_ub = *p_lb + (kmp_int32)(size - 1) * kmp_loop.st;
+    *p_st = kmp_loop.st;
+    if (p_last != NULL) *p_last = (first + size == trip);
 
-    team->loop_start += team->loop_chunk;
-    KMP_PRINTF(10,
-               "__kmpc_dispatch_next_4 : last: %d [l %4d u %4d s %4d] "
-               "team->loop_start %d\n",
-               *p_last, *p_lb, *p_ub, *p_st, team->loop_start);
-    eu_mutex_release();
+    KMP_PRINTF(10, "__kmpc_dispatch_next_4 : last: %d [l %4d u %4d s %4d]\n",
+               first + size == trip, *p_lb, *p_ub, *p_st);
     return 1;
 }
 
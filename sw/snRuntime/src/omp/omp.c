@@ -44,7 +44,20 @@ omp_prof_t *omp_prof;
 //================================================================================
 static inline void initTeam(omp_t *_this, omp_team_t *team) {
     (void)_this;
+#ifndef OMPSTATIC_NUMTHREADS
+    // Restart the epochs of the dynamically scheduled loops, which are counted
+    // per parallel region
+    for (int i = 0; i < OMP_LOOP_SLOTS; i++) {
+        team->loops[i].epoch = i;
+        team->loops[i].next = 0;
+        team->loops[i].left = 0;
+    }
+    for (unsigned i = 0;
+         i < sizeof(team->core_epoch) / sizeof(team->core_epoch[0]); i++)
+        team->core_epoch[i] = 0;
+#else
     (void)team;
+#endif
 }
 
 void omp_init(void) {
@@ -59,24 +72,25 @@ void omp_init(void) {
         omp_p->maxThreads = nbCores;
 
         omp_p->plainTeam.nbThreads = nbCores;
-        omp_p->plainTeam.loop_epoch = 0;
-        omp_p->plainTeam.loop_is_setup = 0;
-
-        for (int i = 0; i < sizeof(omp_p->plainTeam.core_epoch) /
-                                sizeof(omp_p->plainTeam.core_epoch[0]);
-             i++)
-            omp_p->plainTeam.core_epoch[i] = 0;
 
         initTeam(omp_p, &omp_p->plainTeam);
         omp_p->kmpc_barrier =
             (struct snrt_barrier *)snrt_l1alloc(sizeof(struct snrt_barrier));
-        snrt_memset(omp_p->kmpc_barrier, 0, sizeof(struct snrt_barrier));
+        snrt_memset_scalar(omp_p->kmpc_barrier, 0, sizeof(struct snrt_barrier));
+        omp_p->kmpc_reduce = (omp_reduce_slot_t *)snrt_l1alloc(
+            sizeof(omp_reduce_slot_t) * nbCores);
+        snrt_memset_scalar(omp_p->kmpc_reduce, 0,
+                           sizeof(omp_reduce_slot_t) * nbCores);
         // Exchange omp pointer with other cluster cores
         omp_p_global = omp_p;
 #else
         omp_p.kmpc_barrier =
             (struct snrt_barrier *)snrt_l1alloc(sizeof(struct snrt_barrier));
-        snrt_memset(omp_p.kmpc_barrier, 0, sizeof(struct snrt_barrier));
+        snrt_memset_scalar(omp_p.kmpc_barrier, 0, sizeof(struct snrt_barrier));
+        omp_p.kmpc_reduce = (omp_reduce_slot_t *)snrt_l1alloc(
+            sizeof(omp_reduce_slot_t) * OMPSTATIC_NUMTHREADS);
+        snrt_memset_scalar(omp_p.kmpc_reduce, 0,
+                           sizeof(omp_reduce_slot_t) * OMPSTATIC_NUMTHREADS);
         // Exchange omp pointer with other cluster cores
         omp_p_global = &omp_p;
 #endif
@@ -134,6 +148,7 @@ void partialParallelRegion(int32_t argc, void *data,
                            void (*fn)(void *, uint32_t), int num_threads) {
 #ifndef OMPSTATIC_NUMTHREADS
     omp_p->plainTeam.nbThreads = num_threads;
+    initTeam(omp_p, &omp_p->plainTeam);
 #endif
 
     OMP_PRINTF(10, "num_threads=%d nbThreads=%d omp_p->numThreads=%d\n",
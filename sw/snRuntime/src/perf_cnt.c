@@ -3,25 +3,113 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "perf_cnt.h"
 
+#include <stddef.h>
+
+#include "spatz_cluster_peripheral.h"
+
+#define PERF_REG_OFFSET(reg)                       \
+    (SPATZ_CLUSTER_PERIPHERAL_##reg##_REG_OFFSET - \
+     SPATZ_CLUSTER_PERIPHERAL_PERF_COUNTER_ENABLE_0_REG_OFFSET)
+
+_Static_assert(SNRT_PERF_N_CNT ==
+                   SPATZ_CLUSTER_PERIPHERAL_PARAM_NUM_PERF_COUNTERS,
+               "perf_reg_t does not match spatz_cluster_peripheral");
+_Static_assert(offsetof(perf_reg_t, spatz_enable) ==
+                   PERF_REG_OFFSET(PERF_COUNTER_SPATZ_ENABLE_0),
+               "perf_reg_t does not match spatz_cluster_peripheral");
+_Static_assert(offsetof(perf_reg_t, perf_counter_hi) ==
+                   PERF_REG_OFFSET(PERF_COUNTER_HI_0),
+               "perf_reg_t does not match spatz_cluster_peripheral");
+_Static_assert(offsetof(perf_reg_t, freeze) ==
+                   PERF_REG_OFFSET(PERF_COUNTER_FREEZE),
+               "perf_reg_t does not match spatz_cluster_peripheral");
+
+static const char *const perf_cnt_type_names[] = {
+    [SNRT_PERF_CNT_CYCLES] = "cycles",
+    [SNRT_PERF_CNT_TCDM_ACCESSED] = "tcdm_accessed",
+    [SNRT_PERF_CNT_TCDM_CONGESTED] = "tcdm_congested",
+    [SNRT_PERF_CNT_ISSUE_FPU] = "issue_fpu",
+    [SNRT_PERF_CNT_ISSUE_FPU_SEQ] = "issue_fpu_seq",
+    [SNRT_PERF_CNT_ISSUE_CORE_TO_FPU] = "issue_core_to_fpu",
+    [SNRT_PERF_CNT_RETIRED_INSTR] = "retired_instr",
+    [SNRT_PERF_CNT_RETIRED_LOAD] = "retired_load",
+    [SNRT_PERF_CNT_RETIRED_I] = "retired_i",
+    [SNRT_PERF_CNT_RETIRED_ACC] = "retired_acc",
+    [SNRT_PERF_CNT_DMA_AW_STALL] = "dma_aw_stall",
+    [SNRT_PERF_CNT_DMA_AR_STALL] = "dma_ar_stall",
+    [SNRT_PERF_CNT_DMA_R_STALL] = "dma_r_stall",
+    [SNRT_PERF_CNT_DMA_W_STALL] = "dma_w_stall",
+    [SNRT_PERF_CNT_DMA_BUF_W_STALL] = "dma_buf_w_stall",
+    [SNRT_PERF_CNT_DMA_BUF_R_STALL] = "dma_buf_r_stall",
+    [SNRT_PERF_CNT_DMA_AW_DONE] = "dma_aw_done",
+    [SNRT_PERF_CNT_DMA_AW_BW] = "dma_aw_bw",
+    [SNRT_PERF_CNT_DMA_AR_DONE] = "dma_ar_done",
+    [SNRT_PERF_CNT_DMA_AR_BW] = "dma_ar_bw",
+    [SNRT_PERF_CNT_DMA_R_DONE] = "dma_r_done",
+    [SNRT_PERF_CNT_DMA_R_BW] = "dma_r_bw",
+    [SNRT_PERF_CNT_DMA_W_DONE] = "dma_w_done",
+    [SNRT_PERF_CNT_DMA_W_BW] = "dma_w_bw",
+    [SNRT_PERF_CNT_DMA_B_DONE] = "dma_b_done",
+    [SNRT_PERF_CNT_DMA_BUSY] = "dma_busy",
+    [SNRT_PERF_CNT_ICACHE_MISS] = "icache_miss",
+    [SNRT_PERF_CNT_ICACHE_HIT] = "icache_hit",
+    [SNRT_PERF_CNT_ICACHE_PREFETCH] = "icache_prefetch",
+    [SNRT_PERF_CNT_ICACHE_DOUBLE_HIT] = "icache_double_hit",
+    [SNRT_PERF_CNT_ICACHE_STALL] = "icache_stall",
+    [SNRT_PERF_CNT_SPATZ_VFU_BUSY] = "vfu_busy",
+    [SNRT_PERF_CNT_SPATZ_VFU_STALL] = "vfu_stall",
+    [SNRT_PERF_CNT_SPATZ_VLSU_STALL] = "vlsu_stall",
+    [SNRT_PERF_CNT_SPATZ_VLSU_TCDM_STALL] = "vlsu_tcdm_stall",
+    [SNRT_PERF_CNT_SPATZ_VSLDU_BUSY] = "vsldu_busy",
+    [SNRT_PERF_CNT_SPATZ_VRF_CONFLICT] = "vrf_conflict",
+    [SNRT_PERF_CNT_SPATZ_CHAINING_STALL] = "chaining_stall",
+    [SNRT_PERF_CNT_SPATZ_ISSUE_FULL] = "issue_full",
+    [SNRT_PERF_CNT_SPATZ_RETIRED_VINSN] = "retired_vinsn",
+};
+
+// Set or clear the freeze of all perf_counters. The fence makes sure the
+// freeze took effect before any counter is accessed.
+static inline void perf_freeze(uint32_t freeze) {
+    perf_reg_t *perf_reg = (void *)snrt_peripherals()->perf_counters;
+    perf_reg->freeze.value = freeze;
+    asm volatile("fence" ::: "memory");
+}
+
+// Select the event of a specific perf_counter
+static inline void perf_enable(enum snrt_perf_cnt perf_cnt,
+                               enum snrt_perf_cnt_type perf_cnt_type) {
+    perf_reg_t *perf_reg = (void *)snrt_peripherals()->perf_counters;
+    if (perf_cnt_type >= SNRT_PERF_CNT_SPATZ_VFU_BUSY) {
+        perf_reg->enable[perf_cnt].value = 0x0;
+        perf_reg->spatz_enable[perf_cnt].value =
+            (0x1 << (perf_cnt_type - SNRT_PERF_CNT_SPATZ_VFU_BUSY));
+    } else {
+        perf_reg->spatz_enable[perf_cnt].value = 0x0;
+        perf_reg->enable[perf_cnt].value = (0x1 << perf_cnt_type);
+    }
+}
+
 // Enable a specific perf_counter
 void snrt_start_perf_counter(enum snrt_perf_cnt perf_cnt,
                              enum snrt_perf_cnt_type perf_cnt_type,
                              uint32_t hart_id) {
     perf_reg_t *perf_reg = (void *)snrt_peripherals()->perf_counters;
-    perf_reg->hart_select[perf_cnt].value |= hart_id;
-    perf_reg->enable[perf_cnt].value = (0x1 << perf_cnt_type);
+    perf_reg->hart_select[perf_cnt].value = hart_id;
+    perf_enable(perf_cnt, perf_cnt_type);
 }
 
 // Stops the counter but does not reset it
 void snrt_stop_perf_counter(enum snrt_perf_cnt perf_cnt) {
     perf_reg_t *perf_reg = (void *)snrt_peripherals()->perf_counters;
     perf_reg->enable[perf_cnt].value = 0x0;
+    perf_reg->spatz_enable[perf_cnt].value = 0x0;
 }
 
 // Resets the counter completely
 void snrt_reset_perf_counter(enum snrt_perf_cnt perf_cnt) {
     perf_reg_t *perf_reg = (void *)snrt_peripherals()->perf_counters;
     perf_reg->enable[perf_cnt].value = 0x0;
+    perf_reg->spatz_enable[perf_cnt].value = 0x0;
     perf_reg->hart_select[perf_cnt].value = 0x0;
     perf_reg->perf_counter[perf_cnt].value = 0x0;
 }
@@ -31,3 +119,51 @@ uint32_t snrt_get_perf_counter(enum snrt_perf_cnt perf_cnt) {
     perf_reg_t *perf_reg = (void *)snrt_peripherals()->perf_counters;
     return (uint32_t)perf_reg->perf_counter[perf_cnt].value;
 }
+
+// Reset and configure all counters of a group while the counters are frozen,
+// such that they all start counting in the same cycle.
+void snrt_perf_group_start(const struct snrt_perf_group *group) {
+    perf_reg_t *perf_reg = (void *)snrt_peripherals()->perf_counters;
+    perf_freeze(1);
+    for (uint32_t i = 0; i < group->num; i++) {
+        // Clears both halves of the 64-bit counter
+        perf_reg->perf_counter[i].value = 0x0;
+        perf_reg->hart_select[i].value = group->hart_id[i];
+        perf_enable(i, group->type[i]);
+    }
+    perf_freeze(0);
+}
+
+// Stop all counters of a group in the same cycle. Their values are kept.
+void snrt_perf_group_stop(const struct snrt_perf_group *group) {
+    perf_reg_t *perf_reg = (void *)snrt_peripherals()->perf_counters;
+    perf_freeze(1);
+    for (uint32_t i = 0; i < group->num; i++) {
+        perf_reg->enable[i].value = 0x0;
+        perf_reg->spatz_enable[i].value = 0x0;
+    }
+    perf_freeze(0);
+}
+
+// Read the 64-bit values of all counters of a group. The counters are frozen
+// while they are read and do not count the events of these cycles.
+void snrt_perf_group_read(const struct snrt_perf_group *group,
+                          struct snrt_perf_snapshot *snapshot) {
+    perf_reg_t *perf_reg = (void *)snrt_peripherals()->perf_counters;
+    uint32_t frozen = perf_reg->freeze.value;
+    if (!frozen) perf_freeze(1);
+    for (uint32_t i = 0; i < group->num; i++) {
+        uint64_t hi = perf_reg->perf_counter_hi[i].value;
+        snapshot->value[i] = hi << 32 | perf_reg->perf_counter[i].value;
+    }
+    if (!frozen) perf_freeze(0);
+}
+
+// Get the name of a type of performance counter
+const char *snrt_perf_cnt_type_name(enum snrt_perf_cnt_type perf_cnt_type) {
+    if ((uint32_t)perf_cnt_type >=
+            sizeof(perf_cnt_type_names) / sizeof(perf_cnt_type_names[0]) ||
+        !perf_cnt_type_names[perf_cnt_type])
+        return "unknown";
+    return perf_cnt_type_names[perf_cnt_type];
+}
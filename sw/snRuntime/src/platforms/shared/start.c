@@ -82,7 +82,11 @@ void _snrt_init_team(uint32_t cluster_core_id, uint32_t cluster_core_num,
         (uint32_t *)(spm_start + bootdata->tcdm_size +
                      SPATZ_CLUSTER_PERIPHERAL_CL_CLINT_SET_REG_OFFSET);
 
-    // Init allocator
-    snrt_alloc_init(team, sizeof(struct putc_buffer));
+    // Init allocator. The L3 heap starts behind the string buffers, which
+    // `putchar` indexes by the hart id.
+    snrt_alloc_init(
+        team, spm_end,
+        (bootdata->hartid_base + bootdata->core_count) *
+            sizeof(struct putc_buffer));
     snrt_int_init(team);
 }
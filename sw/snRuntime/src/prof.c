@@ -0,0 +1,56 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+#include "prof.h"
+
+#include "printf.h"
+
+__thread struct snrt_prof_region *_snrt_prof_regions;
+__thread uint32_t _snrt_prof_perf;
+
+// Set once any hart allocated a region table
+static volatile uint32_t prof_used __attribute__((section(".dram")));
+
+struct snrt_prof_region *snrt_prof_init() {
+    if (_snrt_prof_regions) return _snrt_prof_regions;
+    size_t size = SNRT_PROF_MAX_REGIONS * sizeof(struct snrt_prof_region);
+    struct snrt_prof_region *regions = snrt_l1alloc(size);
+    if (!regions) regions = snrt_l3alloc(size);
+    if (!regions) return 0;
+    snrt_memset_scalar(regions, 0, size);
+    _snrt_prof_regions = regions;
+    prof_used = 1;
+    return regions;
+}
+
+static void prof_print() {
+    if (!_snrt_prof_regions) return;
+    for (uint32_t id = 0; id < SNRT_PROF_MAX_REGIONS; id++) {
+        struct snrt_prof_region *region = &_snrt_prof_regions[id];
+        if (!region->count) continue;
+        printf("[prof] hart=%u region=%u count=%u cycles=%llu instret=%llu",
+               snrt_hartid(), id, region->count, region->cycles,
+               region->instret);
+        if (_snrt_prof_perf)
+            for (uint32_t i = 0; i < SNRT_PERF_N_CNT; i++)
+                printf(" perf%u=%llu", i, region->perf[i]);
+        printf("\n");
+    }
+}
+
+/**
+ * @brief Print the profiled regions of all harts of the cluster
+ * @details Called by all harts of the cluster after `main` returned. The
+ * harts print their tables in turn, since the putc buffers are flushed
+ * through the same host interface. Returns right away if no hart used the
+ * profiler.
+ */
+void snrt_prof_report() {
+    if (!prof_used) return;
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t core_num = snrt_cluster_core_num();
+    for (uint32_t i = 0; i < core_num; i++) {
+        if (i == core_idx) prof_print();
+        snrt_cluster_hw_barrier();
+    }
+}
@@ -0,0 +1,64 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+#include <printf.h>
+#include <snrt.h>
+
+#define L3_CHUNK_WORDS 512
+
+static uint32_t *volatile l3_chunk;
+
+int main() {
+    uint32_t errors = 0;
+
+    // Printing on any hart leaves the L3 heap alone
+    if (snrt_cluster_core_idx() == 0) {
+        l3_chunk = snrt_l3alloc(L3_CHUNK_WORDS * sizeof(uint32_t));
+        for (uint32_t i = 0; i < L3_CHUNK_WORDS; i++) l3_chunk[i] = i;
+    }
+    snrt_cluster_hw_barrier();
+    printf("alloc: hart %u prints next to the L3 heap\n", snrt_hartid());
+    snrt_cluster_hw_barrier();
+    if (snrt_cluster_core_idx() != 0) return 0;
+    for (uint32_t i = 0; i < L3_CHUNK_WORDS; i++) errors += (l3_chunk[i] != i);
+
+    // Freed chunks are reused
+    void *a = snrt_l1alloc(100);
+    void *b = snrt_l1alloc(100);
+    errors += (a == 0 || b == 0 || a == b);
+    snrt_l1free(a);
+    void *c = snrt_l1alloc(64);
+    errors += (c != a);
+
+    // Alignment
+    for (uint32_t align = 8; align <= 1024; align *= 2) {
+        void *p = snrt_l1alloc_aligned(24, align);
+        errors += (p == 0 || ((uint32_t)p & (align - 1)) != 0);
+    }
+    errors += ((uint32_t)snrt_l1alloc_aligned(8, SNRT_L1_ALIGN_BANKS) &
+               (SNRT_L1_ALIGN_BANKS - 1)) != 0;
+
+    // Frames release all chunks allocated within them
+    snrt_l1_mark_t outer = snrt_l1_mark();
+    void *d = snrt_l1alloc(256);
+    snrt_l1_mark_t inner = snrt_l1_mark();
+    void *e = snrt_l1alloc(512);
+    snrt_l1_release(inner);
+    errors += (snrt_l1alloc(512) != e);
+    snrt_l1_release(outer);
+    errors += (snrt_l1alloc(256) != d);
+
+    // Chunks freed at the top of the heap give back their memory
+    void *f = snrt_l1alloc(4096);
+    snrt_l1free(f);
+    errors += (snrt_l1alloc(8192) != f);
+
+    // The TCDM and the L3 are bounded
+    errors += (snrt_l1alloc(1 << 30) != 0);
+    errors += (snrt_l3alloc(0xfffffff0) != 0);
+    errors += (snrt_l3alloc(64) == 0);
+
+    snrt_l1free(b);
+    snrt_l1free(c);
+    return errors;
+}
@@ -0,0 +1,96 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/* Checks the paths of `snrt_memcpy` and `snrt_memset` and prints the bytes
+ * per cycle each of them achieves for a range of sizes. */
+
+#include <printf.h>
+#include <snrt.h>
+
+#define MAX_SIZE 4096
+
+typedef void *(*copy_fn_t)(void *, const void *, size_t);
+typedef void *(*fill_fn_t)(void *, int, size_t);
+
+// Buffer in the main memory
+uint8_t buffer_l3[MAX_SIZE];
+
+static const size_t sizes[] = {16, 64, 256, 1024, MAX_SIZE};
+
+static void fill(uint8_t *buf, size_t n, uint8_t seed) {
+    for (size_t i = 0; i < n; i++) buf[i] = (uint8_t)(seed + i);
+}
+
+// Copy `n` bytes with `fn`, check the result and report the throughput
+static uint32_t bench_copy(const char *name, copy_fn_t fn, uint8_t *dst,
+                           uint8_t *src, size_t n) {
+    uint32_t errors = 0;
+
+    fill(src, n + 1, 7);
+    fill(dst, n + 1, 0);
+    // Cold run to warm up the instruction cache
+    fn(dst, src, n);
+    size_t start = read_csr(mcycle);
+    fn(dst, src, n);
+    size_t cycles = read_csr(mcycle) - start;
+
+    for (size_t i = 0; i < n; i++) errors += (dst[i] != src[i]);
+    // The byte behind the copy must not be touched
+    errors += (dst[n] != (uint8_t)n);
+
+    printf("[memcpy] path=%s size=%u cycles=%u bytes/cycle=%u.%02u\n", name,
+           n, cycles, n / cycles, (n * 100 / cycles) % 100);
+    return errors;
+}
+
+static uint32_t bench_fill(const char *name, fill_fn_t fn, uint8_t *dst,
+                           size_t n) {
+    uint32_t errors = 0;
+
+    fill(dst, n + 1, 0);
+    fn(dst, 0x5a, n);
+    size_t start = read_csr(mcycle);
+    fn(dst, 0xa5, n);
+    size_t cycles = read_csr(mcycle) - start;
+
+    for (size_t i = 0; i < n; i++) errors += (dst[i] != 0xa5);
+    errors += (dst[n] != (uint8_t)n);
+
+    printf("[memset] path=%s size=%u cycles=%u bytes/cycle=%u.%02u\n", name,
+           n, cycles, n / cycles, (n * 100 / cycles) % 100);
+    return errors;
+}
+
+int main() {
+    // Only the core with the DMA can exercise all paths
+    if (snrt_cluster_core_idx() != 0) return 0;
+    uint32_t errors = 0;
+
+    uint8_t *src = snrt_l1alloc(MAX_SIZE + 8);
+    uint8_t *dst = snrt_l1alloc(MAX_SIZE + 8);
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        size_t n = sizes[i];
+        errors += bench_copy("scalar", snrt_memcpy_scalar, dst, src, n);
+        errors += bench_copy("vector", snrt_memcpy_vector, dst, src, n);
+        errors += bench_copy("dma", snrt_memcpy_dma, dst, src, n);
+        errors += bench_copy("auto", snrt_memcpy, dst, src, n);
+        // Misaligned buffers
+        errors += bench_copy("scalar-misaligned", snrt_memcpy_scalar, dst + 1,
+                             src + 2, n);
+        errors += bench_copy("vector-misaligned", snrt_memcpy_vector, dst + 1,
+                             src + 2, n);
+        // Copies from the main memory
+        errors += bench_copy("scalar-l3", snrt_memcpy_scalar, dst, buffer_l3,
+                             n - 1);
+        errors += bench_copy("dma-l3", snrt_memcpy_dma, dst, buffer_l3, n - 1);
+        errors += bench_copy("auto-l3", snrt_memcpy, dst, buffer_l3, n - 1);
+
+        errors += bench_fill("scalar", snrt_memset_scalar, dst + 1, n);
+        errors += bench_fill("vector", snrt_memset_vector, dst + 1, n);
+        errors += bench_fill("auto", snrt_memset, dst, n);
+    }
+
+    return errors;
+}
@@ -0,0 +1,62 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/* Reductions of OpenMP parallel regions and loops, which go through
+ * `__kmpc_reduce` and `__kmpc_reduce_nowait`. */
+
+#include <dm.h>
+#include <omp.h>
+#include <snrt.h>
+
+#define N 64
+
+int main() {
+    unsigned core_idx = snrt_cluster_core_idx();
+    __snrt_omp_bootstrap(core_idx);
+
+    uint32_t errors = 0;
+    unsigned int num_threads = omp_getData()->numThreads;
+
+    // Scalar sums of a parallel region
+    double sum = 0;
+    float sumf = 0;
+#pragma omp parallel reduction(+ : sum, sumf)
+    {
+        sum += omp_get_thread_num() + 1;
+        sumf += 0.5f;
+    }
+    errors += (sum != num_threads * (num_threads + 1) / 2);
+    errors += (sumf != 0.5f * num_threads);
+
+    // Several variables and operators in a blocking loop reduction
+    int total = 0, max = -1;
+    double prod = 1;
+#pragma omp parallel
+    {
+#pragma omp for reduction(+ : total) reduction(max : max) reduction(* : prod)
+        for (int i = 0; i < N; i++) {
+            total += i;
+            if (i > max) max = i;
+            prod *= (i % 8 == 0) ? 2 : 1;
+        }
+    }
+    errors += (total != N * (N - 1) / 2);
+    errors += (max != N - 1);
+    errors += (prod != 256);
+
+    // Back-to-back loop reductions without a barrier
+    int a = 0, b = 0;
+#pragma omp parallel
+    {
+#pragma omp for reduction(+ : a) nowait
+        for (int i = 0; i < N; i++) a += 1;
+#pragma omp for reduction(+ : b) nowait
+        for (int i = 0; i < N; i++) b += 2;
+    }
+    errors += (a != N);
+    errors += (b != 2 * N);
+
+    __snrt_omp_destroy(core_idx);
+    return errors;
+}
@@ -0,0 +1,112 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/* Overhead of the OpenMP loop schedules, following the EPCC schedbench. Every
+ * schedule runs `ITERS_PER_THREAD` iterations per thread of `DELAY` cycles
+ * each, `REPS` times back to back. The overhead is the difference to the time
+ * a single thread takes for its share of the iterations. The loops also count
+ * how often each iteration ran, which checks the schedules. */
+
+#include <dm.h>
+#include <omp.h>
+#include <printf.h>
+#include <snrt.h>
+
+#define ITERS_PER_THREAD 128
+#define DELAY 32
+#define REPS 8
+
+static uint32_t *hits;
+
+static inline void work(unsigned int i) {
+    for (unsigned int j = 0; j < DELAY; j++) asm volatile("nop");
+    __atomic_add_fetch(&hits[i], 1, __ATOMIC_RELAXED);
+}
+
+static uint32_t run_reference(unsigned int n) {
+    uint32_t start = read_csr(mcycle);
+    for (unsigned int r = 0; r < REPS; r++)
+        for (unsigned int i = 0; i < n; i++) work(i);
+    return read_csr(mcycle) - start;
+}
+
+static uint32_t run_static(unsigned int n, unsigned int chunk) {
+    uint32_t start = read_csr(mcycle);
+#pragma omp parallel
+    for (unsigned int r = 0; r < REPS; r++) {
+#pragma omp for schedule(static, chunk)
+        for (unsigned int i = 0; i < n; i++) work(i);
+    }
+    return read_csr(mcycle) - start;
+}
+
+static uint32_t run_dynamic(unsigned int n, unsigned int chunk) {
+    uint32_t start = read_csr(mcycle);
+#pragma omp parallel
+    for (unsigned int r = 0; r < REPS; r++) {
+#pragma omp for schedule(dynamic, chunk)
+        for (unsigned int i = 0; i < n; i++) work(i);
+    }
+    return read_csr(mcycle) - start;
+}
+
+static uint32_t run_dynamic_nowait(unsigned int n, unsigned int chunk) {
+    uint32_t start = read_csr(mcycle);
+#pragma omp parallel
+    for (unsigned int r = 0; r < REPS; r++) {
+#pragma omp for schedule(dynamic, chunk) nowait
+        for (unsigned int i = 0; i < n; i++) work(i);
+    }
+    return read_csr(mcycle) - start;
+}
+
+static uint32_t run_guided(unsigned int n, unsigned int chunk) {
+    uint32_t start = read_csr(mcycle);
+#pragma omp parallel
+    for (unsigned int r = 0; r < REPS; r++) {
+#pragma omp for schedule(guided, chunk)
+        for (unsigned int i = 0; i < n; i++) work(i);
+    }
+    return read_csr(mcycle) - start;
+}
+
+// Run a schedule, check that every iteration ran `REPS` times and report the
+// overhead against the reference
+static uint32_t bench(const char *name, uint32_t (*run)(unsigned, unsigned),
+                      unsigned int n, unsigned int chunk, uint32_t ref) {
+    uint32_t errors = 0;
+
+    for (unsigned int i = 0; i < n; i++) hits[i] = 0;
+    uint32_t cycles = run(n, chunk);
+    for (unsigned int i = 0; i < n; i++) errors += (hits[i] != REPS);
+
+    printf("[schedbench] schedule=%s chunk=%u cycles=%u overhead=%d\n", name,
+           chunk, cycles / REPS, (int)(cycles - ref) / REPS);
+    return errors;
+}
+
+int main() {
+    unsigned core_idx = snrt_cluster_core_idx();
+    __snrt_omp_bootstrap(core_idx);
+
+    uint32_t errors = 0;
+    unsigned int num_threads = omp_getData()->numThreads;
+    unsigned int n = ITERS_PER_THREAD * num_threads;
+    hits = snrt_l1alloc(n * sizeof(uint32_t));
+
+    // A single thread executing its share of the iterations
+    uint32_t ref = run_reference(ITERS_PER_THREAD);
+    printf("[schedbench] threads=%u iterations=%u delay=%u reference=%u\n",
+           num_threads, n, DELAY, ref / REPS);
+
+    for (unsigned int chunk = 1; chunk <= ITERS_PER_THREAD; chunk *= 4) {
+        errors += bench("static", run_static, n, chunk, ref);
+        errors += bench("dynamic", run_dynamic, n, chunk, ref);
+        errors += bench("dynamic-nowait", run_dynamic_nowait, n, chunk, ref);
+        errors += bench("guided", run_guided, n, chunk, ref);
+    }
+
+    __snrt_omp_destroy(core_idx);
+    return errors;
+}
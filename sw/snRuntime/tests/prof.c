@@ -0,0 +1,28 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+#include <prof.h>
+#include <snrt.h>
+
+int main() {
+    uint32_t errors = 0;
+
+    for (uint32_t i = 0; i < 3; i++) {
+        snrt_prof_region_begin(1);
+        asm volatile("nop");
+        snrt_prof_region_end(1);
+    }
+
+    // Out-of-range regions are ignored
+    snrt_prof_region_begin(SNRT_PROF_MAX_REGIONS);
+    snrt_prof_region_end(SNRT_PROF_MAX_REGIONS);
+
+    errors += (_snrt_prof_regions == 0);
+    struct snrt_prof_region *region = &_snrt_prof_regions[1];
+    errors += (region->count != 3);
+    errors += (region->cycles == 0);
+    errors += (region->instret == 0);
+    errors += (_snrt_prof_regions[0].count != 0);
+
+    return errors;
+}
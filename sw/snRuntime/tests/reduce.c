@@ -0,0 +1,21 @@
+// Copyright 2023 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+#include <snrt.h>
+
+int main() {
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t core_num = snrt_cluster_core_num();
+    uint32_t errors = 0;
+
+    // Back-to-back reductions cycle through both sets of slots
+    for (uint32_t i = 0; i < 4; i++) {
+        double expected = core_num * (core_num + 1) / 2 + i * core_num;
+        double sum = snrt_cluster_reduce_sum_f64(core_idx + 1 + i);
+        errors += (sum != expected);
+        float sumf = snrt_cluster_reduce_sum_f32(core_idx + 1 + i);
+        errors += (sumf != (float)expected);
+    }
+
+    return errors;
+}
@@ -4,11 +4,32 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "benchmark.h"
 #include "encoding.h"
+#include "perf_cnt.h"
 #include "spatz_cluster_peripheral.h"
 #include "team.h"
 
 extern __thread struct snrt_team *_snrt_team_current;
 
+// Width of a TCDM access of the cores
+#define TCDM_WORD_BYTES 8
+
+// Performance counters sampled between `start_kernel` and `stop_kernel`. By
+// default, the busy cycles of the vector FPUs and the congested TCDM accesses
+// are counted. With `BENCHMARK_PERF_TCDM`, the accessed TCDM words replace the
+// busy cycles so that `benchmark_report` can derive the granted accesses, the
+// accessed minus the congested ones.
+static const struct snrt_perf_group perf_group = {
+    .num = SNRT_PERF_N_CNT,
+#ifdef BENCHMARK_PERF_TCDM
+    .type = {SNRT_PERF_CNT_TCDM_ACCESSED, SNRT_PERF_CNT_TCDM_CONGESTED},
+#else
+    .type = {SNRT_PERF_CNT_SPATZ_VFU_BUSY, SNRT_PERF_CNT_TCDM_CONGESTED},
+#endif
+    .hart_id = {0, 0},
+};
+static struct snrt_perf_snapshot perf_snapshot;
+static int perf_running;
+
 size_t benchmark_get_cycle() { return read_csr(mcycle); }
 
 void start_kernel() {
@@ -16,11 +37,46 @@ void start_kernel() {
       (uint32_t *)(_snrt_team_current->root->cluster_mem.end +
                    SPATZ_CLUSTER_PERIPHERAL_SPATZ_STATUS_REG_OFFSET);
   *bench = 1;
+
+  snrt_perf_group_start(&perf_group);
+  perf_running = 1;
 }
 
 void stop_kernel() {
+  if (perf_running) {
+    snrt_perf_group_stop(&perf_group);
+    snrt_perf_group_read(&perf_group, &perf_snapshot);
+    perf_running = 0;
+  }
+
   uint32_t *bench =
       (uint32_t *)(_snrt_team_current->root->cluster_mem.end +
                    SPATZ_CLUSTER_PERIPHERAL_SPATZ_STATUS_REG_OFFSET);
   *bench = 0;
 }
+
+void benchmark_print_perf(size_t cycles) {
+  for (unsigned int i = 0; i < perf_group.num; i++) {
+    uint64_t value = perf_snapshot.value[i];
+    printf("Counter %u: %s = %llu (%llu%%o of %u cycles).\n", i,
+           snrt_perf_cnt_type_name(perf_group.type[i]), value,
+           cycles ? 1000 * value / cycles : 0, (unsigned int)cycles);
+  }
+}
+
+void benchmark_report(const char *kernel, uint64_t ops, unsigned int simd,
+                      uint64_t dram_bytes, size_t cycles) {
+#ifdef BENCHMARK_PERF_TCDM
+  uint64_t granted = perf_snapshot.value[0] - perf_snapshot.value[1];
+  printf("[roofline] kernel=%s ops=%llu simd=%u tcdm_bytes=%llu "
+         "dram_bytes=%llu cycles=%u cores=%u\n",
+         kernel, ops, simd, TCDM_WORD_BYTES * granted, dram_bytes,
+         (unsigned int)cycles, snrt_cluster_core_num());
+#else
+  // The TCDM accesses are not counted.
+  printf("[roofline] kernel=%s ops=%llu simd=%u dram_bytes=%llu cycles=%u "
+         "cores=%u\n",
+         kernel, ops, simd, dram_bytes, (unsigned int)cycles,
+         snrt_cluster_core_num());
+#endif
+}
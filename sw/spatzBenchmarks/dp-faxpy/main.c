@@ -103,8 +103,11 @@ int main() {
 
     printf("\n----- (%d) axpy -----\n", dim);
     printf("The execution took %u cycles.\n", timer);
+    benchmark_print_perf(timer);
     printf("The performance is %ld OP/1000cycle (%ld%%o utilization).\n",
            performance, utilization);
+    size_t dram_bytes = 2 * dim * sizeof(double);
+    benchmark_report("dp-faxpy", 2ull * dim, 1, dram_bytes, timer);
   }
 
   if (cid == 0) {
@@ -92,23 +92,19 @@ int main() {
   // Calculate fconv2d
   //
 
-  // Start timer
-  timer_start = benchmark_get_cycle();
-
   // Start dump
   if (cid == 0)
     start_kernel();
 
+  // Start timer
+  timer_start = benchmark_get_cycle();
+
   // Calculate the result
   conv3d_CHx7x7(o, i, fmtx, r / num_cores, r, c, f);
 
   // Wait for all cores to finish
   snrt_cluster_hw_barrier();
 
-  // End dump
-  if (cid == 0)
-    stop_kernel();
-
   // End timer
   if (cid == 0) {
     timer_end = benchmark_get_cycle();
@@ -127,8 +123,13 @@ int main() {
 
     printf("\n----- (%dx%d) dp fconv2d -----\n", r, c);
     printf("The execution took %u cycles.\n", timer);
+    benchmark_print_perf(timer);
     printf("The performance is %lu OP/1000cycle (%lu%%o utilization).\n",
            performance, utilization);
+    size_t dram_bytes =
+        ((r + f - 1) * (c + f - 1) + r * c + f * f) * sizeof(double);
+    benchmark_report("dp-fconv2d", 2ull * f * f * r * c, 1, dram_bytes,
+                     timer);
   }
 
   if (cid == 0)
@@ -51,7 +51,7 @@ int main() {
   if (cid == 0) {
     a = (double *)snrt_l1alloc(dotp_l.M * sizeof(double));
     b = (double *)snrt_l1alloc(dotp_l.M * sizeof(double));
-    result = (double *)snrt_l1alloc(num_cores * sizeof(double));
+    result = (double *)snrt_l1alloc(sizeof(double));
   }
 
   // Initialize the matrices
@@ -82,20 +82,11 @@ int main() {
   // Calculate dotp
   double acc;
   acc = fdotp_v64b(a_int, b_int, dim);
-  result[cid] = acc;
 
-  // Wait for all cores to finish
-  snrt_cluster_hw_barrier();
-
-  // Final reduction
-  if (cid == 0) {
-    for (unsigned int i = 1; i < num_cores; ++i)
-      acc += result[i];
+  // Final reduction, which ends with all cores synchronized
+  acc = snrt_cluster_reduce_sum_f64(acc);
+  if (cid == 0)
     result[0] = acc;
-  }
-
-  // Wait for all cores to finish
-  snrt_cluster_hw_barrier();
 
   // End dump
   if (cid == 0)
@@ -113,8 +104,11 @@ int main() {
 
     printf("\n----- (%d) dp fdotp -----\n", dotp_l.M);
     printf("The execution took %u cycles.\n", timer);
+    benchmark_print_perf(timer);
     printf("The performance is %ld OP/1000cycle (%ld%%o utilization).\n",
            performance, utilization);
+    size_t dram_bytes = 2 * dotp_l.M * sizeof(double);
+    benchmark_report("dp-fdotp", 2ull * dotp_l.M, 1, dram_bytes, timer);
   }
 
   if (cid == 0)
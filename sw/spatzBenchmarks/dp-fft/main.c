@@ -81,6 +81,9 @@ int main() {
   double *buf_ = buffer + cid * (NFFT >> 1);
   double *twi_ = twiddle + NFFT;
 
+  // Allocate the profiler regions of the kernel outside of the timed section
+  snrt_prof_init();
+
   // Wait for all cores to finish
   snrt_cluster_hw_barrier();
 
@@ -120,8 +123,14 @@ int main() {
 
     printf("\n----- fft on %d samples -----\n", NFFT);
     printf("The execution took %u cycles.\n", timer);
+    benchmark_print_perf(timer);
     printf("The performance is %ld OP/1000cycle (%ld%%o utilization).\n",
            performance, utilization);
+    size_t dram_bytes =
+        (4 * NFFT + 2 * NTWI + NFFT) * sizeof(double) +
+        (log2_nfft + 1) * (NFFT / 4) * sizeof(uint16_t);
+    benchmark_report("dp-fft", 10ull * NFFT * log2_nfft * 6 / 5, 1, dram_bytes,
+                     timer);
 
     // Verify the real part
     for (unsigned int i = 0; i < NFFT; i++) {
@@ -23,10 +23,23 @@
 #include DATAHEADER
 #include "kernel/dp-fmatmul.c"
 
+// Layouts of the matrices in the TCDM. The packed layout aligns all matrices
+// to the first bank, such that the row blocks of the cores and the matrices
+// start in the same banks. The staggered layout skews the matrices and the row
+// blocks of A and C of every core against each other.
+enum layout { LAYOUT_PACKED, LAYOUT_STAGGERED, NUM_LAYOUTS };
+static const char *layout_name[] = {"dp-fmatmul-packed", "dp-fmatmul"};
+
 double *a;
 double *b;
 double *c;
 
+// Offset in elements of the row block of core `cid` in A and C
+static inline unsigned int skew(unsigned int layout, unsigned int cid) {
+  return layout == LAYOUT_STAGGERED ? SNRT_L1_STAGGER(cid) / sizeof(double)
+                                    : 0;
+}
+
 // Verify the matrices
 int verify_matrix(double *matrix, const double *checksum,
                   const unsigned int num_rows, const unsigned int num_columns) {
@@ -58,100 +71,146 @@ int main() {
   unsigned int p_start, p_end;
   unsigned int kernel_size;
 
-  // Allocate the matrices in the local tile
-  if (cid == 0) {
-    a = (double *)snrt_l1alloc(gemm_l.M * gemm_l.K * sizeof(double));
-    b = (double *)snrt_l1alloc(gemm_l.K * gemm_l.N * sizeof(double));
-    c = (double *)snrt_l1alloc(gemm_l.M * gemm_l.N * sizeof(double));
-  }
-
-  // Reset timer
-  timer = (unsigned int)-1;
-
   // Set matrix dimension
   kernel_size = 4;
 
   // Work over complete P dimension
+  const unsigned int rows = gemm_l.M / num_cores;
   p_start = 0;
   p_end = gemm_l.N;
-  m_start = (gemm_l.M / num_cores) * cid;
-  m_end = (gemm_l.M / num_cores) * (cid + 1);
-
-  // Wait for all cores to finish
-  snrt_cluster_hw_barrier();
-
-  // Initialize matrices
-  if (cid == 0) {
-    snrt_dma_start_1d(a, gemm_A_dram, gemm_l.M * gemm_l.K * sizeof(double));
-    snrt_dma_start_1d(b, gemm_B_dram, gemm_l.K * gemm_l.N * sizeof(double));
-    snrt_dma_start_1d(c, gemm_C_dram, gemm_l.M * gemm_l.N * sizeof(double));
-    snrt_dma_wait_all();
-  }
+  m_start = rows * cid;
+  m_end = rows * (cid + 1);
 
-  // Wait for all cores to finish
-  snrt_cluster_hw_barrier();
+  for (unsigned int layout = 0; layout < NUM_LAYOUTS; ++layout) {
+    snrt_l1_mark_t mark = {0, 0};
 
-  // Calculate matmul
-  for (unsigned int i = 0; i < measure_iterations; ++i) {
-    // Start timer
-    timer_start = benchmark_get_cycle();
-
-    // Start dump
-    if (cid == 0)
-      start_kernel();
-
-    if (kernel_size == 2) {
-      matmul_2xVL(c, a, b, m_start, m_end, gemm_l.K, gemm_l.N, p_start, p_end);
-    } else if (kernel_size == 4) {
-      matmul_4xVL(c, a, b, m_start, m_end, gemm_l.K, gemm_l.N, p_start, p_end);
-    } else if (kernel_size == 8) {
-      matmul_8xVL(c, a, b, m_start, m_end, gemm_l.K, gemm_l.N, p_start, p_end);
-    } else {
-      return -2;
+    // Allocate the matrices in the local tile
+    if (cid == 0) {
+      const size_t pad = num_cores * SNRT_L1_STAGGER(1);
+      mark = snrt_l1_mark();
+      if (layout == LAYOUT_STAGGERED) {
+        a = (double *)snrt_l1alloc_staggered(
+            gemm_l.M * gemm_l.K * sizeof(double) + pad, 0);
+        b = (double *)snrt_l1alloc_staggered(
+            gemm_l.K * gemm_l.N * sizeof(double), 1);
+        c = (double *)snrt_l1alloc_staggered(
+            gemm_l.M * gemm_l.N * sizeof(double) + pad, 2);
+      } else {
+        a = (double *)snrt_l1alloc_aligned(
+            gemm_l.M * gemm_l.K * sizeof(double), SNRT_L1_ALIGN_BANKS);
+        b = (double *)snrt_l1alloc_aligned(
+            gemm_l.K * gemm_l.N * sizeof(double), SNRT_L1_ALIGN_BANKS);
+        c = (double *)snrt_l1alloc_aligned(
+            gemm_l.M * gemm_l.N * sizeof(double), SNRT_L1_ALIGN_BANKS);
+      }
     }
 
+    // Reset timer
+    timer = (unsigned int)-1;
+
     // Wait for all cores to finish
     snrt_cluster_hw_barrier();
 
-    // End dump
-    if (cid == 0)
-      stop_kernel();
-
-    // End timer and check if new best runtime
-    timer_end = benchmark_get_cycle();
-    unsigned int timer_temp = timer_end - timer_start;
+    // Initialize matrices, the row blocks of A and C core by core
     if (cid == 0) {
-      if (timer_temp < timer) {
-        timer = timer_temp;
+      for (unsigned int i = 0; i < num_cores; ++i) {
+        snrt_dma_start_1d(a + skew(layout, i) + rows * i * gemm_l.K,
+                          gemm_A_dram + rows * i * gemm_l.K,
+                          rows * gemm_l.K * sizeof(double));
+        snrt_dma_start_1d(c + skew(layout, i) + rows * i * gemm_l.N,
+                          gemm_C_dram + rows * i * gemm_l.N,
+                          rows * gemm_l.N * sizeof(double));
       }
+      snrt_dma_start_1d(b, gemm_B_dram, gemm_l.K * gemm_l.N * sizeof(double));
+      snrt_dma_wait_all();
     }
-  }
 
-  // Check and display results
-  if (cid == 0) {
-    long unsigned int performance =
-        1000 * 2 * gemm_l.M * gemm_l.N * gemm_l.K / timer;
-    long unsigned int utilization =
-        performance / (2 * num_cores * SNRT_NFPU_PER_CORE);
-
-    printf("\n----- (%dx%d) dp fmatmul -----\n", gemm_l.M, gemm_l.N);
-    printf("The execution took %u cycles.\n", timer);
-    printf("The performance is %ld OP/1000cycle (%ld%%o utilization).\n",
-           performance, utilization);
-  }
+    // Wait for all cores to finish
+    snrt_cluster_hw_barrier();
 
-  if (cid == 0) {
-    int error =
-        verify_matrix(c, (const double *)gemm_checksum, gemm_l.M, gemm_l.N);
+    double *a_core = a + skew(layout, cid);
+    double *c_core = c + skew(layout, cid);
+
+    // Calculate matmul
+    for (unsigned int i = 0; i < measure_iterations; ++i) {
+      // Start timer
+      timer_start = benchmark_get_cycle();
+
+      // Start dump
+      if (cid == 0)
+        start_kernel();
+
+      if (kernel_size == 2) {
+        matmul_2xVL(c_core, a_core, b, m_start, m_end, gemm_l.K, gemm_l.N,
+                    p_start, p_end);
+      } else if (kernel_size == 4) {
+        matmul_4xVL(c_core, a_core, b, m_start, m_end, gemm_l.K, gemm_l.N,
+                    p_start, p_end);
+      } else if (kernel_size == 8) {
+        matmul_8xVL(c_core, a_core, b, m_start, m_end, gemm_l.K, gemm_l.N,
+                    p_start, p_end);
+      } else {
+        return -2;
+      }
+
+      // Wait for all cores to finish
+      snrt_cluster_hw_barrier();
+
+      // End dump
+      if (cid == 0)
+        stop_kernel();
 
-    if (error != 0) {
-      printf("Error core %d: c[%d]=%u\n", cid, error, (int)c[error]);
-      return error;
+      // End timer and check if new best runtime
+      timer_end = benchmark_get_cycle();
+      unsigned int timer_temp = timer_end - timer_start;
+      if (cid == 0) {
+        if (timer_temp < timer) {
+          timer = timer_temp;
+        }
+      }
     }
-  }
 
-  // Wait for all cores to finish
-  snrt_cluster_hw_barrier();
+    // Check and display results
+    if (cid == 0) {
+      long unsigned int performance =
+          1000 * 2 * gemm_l.M * gemm_l.N * gemm_l.K / timer;
+      long unsigned int utilization =
+          performance / (2 * num_cores * SNRT_NFPU_PER_CORE);
+
+      printf("\n----- (%dx%d) %s -----\n", gemm_l.M, gemm_l.N,
+             layout_name[layout]);
+      printf("The execution took %u cycles.\n", timer);
+      benchmark_print_perf(timer);
+      printf("The performance is %ld OP/1000cycle (%ld%%o utilization).\n",
+             performance, utilization);
+      size_t dram_bytes =
+          (gemm_l.M * gemm_l.K + gemm_l.K * gemm_l.N + gemm_l.M * gemm_l.N) *
+          sizeof(double);
+      benchmark_report(layout_name[layout],
+                       2ull * gemm_l.M * gemm_l.N * gemm_l.K, 1, dram_bytes,
+                       timer);
+    }
+
+    if (cid == 0) {
+      for (unsigned int i = 0; i < num_cores; ++i) {
+        int error = verify_matrix(
+            c + skew(layout, i) + rows * i * gemm_l.N,
+            (const double *)gemm_checksum + rows * i, rows, gemm_l.N);
+
+        if (error != 0) {
+          int row = rows * i + (error < 0 ? 0 : error);
+          printf("Error core %d: row %d\n", i, row);
+          return row ? row : -1;
+        }
+      }
+    }
+
+    // Wait for all cores to finish
+    snrt_cluster_hw_barrier();
+
+    if (cid == 0)
+      snrt_l1_release(mark);
+  }
 
   return 0;
 }
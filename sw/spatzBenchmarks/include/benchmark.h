@@ -11,3 +11,19 @@ size_t benchmark_get_cycle();
 
 void start_kernel();
 void stop_kernel();
+
+// Print the performance counters sampled between the last `start_kernel` and
+// `stop_kernel` next to the measured cycles.
+void benchmark_print_perf(size_t cycles);
+
+// Print a machine-readable summary of a kernel for `util/roofline.py`:
+//   [roofline] kernel=<name> ops=<n> simd=<n> tcdm_bytes=<n> dram_bytes=<n>
+//   cycles=<n> cores=<n>
+// `ops` counts the arithmetic operations of the kernel and `simd` the
+// elements an FPU processes per operation and cycle, i.e., 64 / SEW. The
+// TCDM bytes are derived from the performance counters and only reported if
+// the benchmarks are built with `-DSPATZ_BENCHMARK_PERF=tcdm`, as `make
+// roofline` does. `dram_bytes` is the data the benchmark moves between DRAM
+// and the TCDM.
+void benchmark_report(const char *kernel, uint64_t ops, unsigned int simd,
+                      uint64_t dram_bytes, size_t cycles);
@@ -156,8 +156,14 @@ int main() {
 
     printf("\n----- (%dx%d) sdotp hp fmatmul -----\n", gemm_l.M, gemm_l.N);
     printf("The execution took %u cycles.\n", timer);
+    benchmark_print_perf(timer);
     printf("The performance is %ld OP/1000cycle (%ld%%o utilization).\n",
            performance, utilization);
+    size_t dram_bytes =
+        (gemm_l.M * gemm_l.K + gemm_l.M * gemm_l.N) * sizeof(__fp16);
+    benchmark_report("sdotp-hp-fmatmul",
+                     2ull * gemm_l.M * gemm_l.N * gemm_l.K, 4, dram_bytes,
+                     timer);
   }
 
   if (cid == 0) {
@@ -18,6 +18,12 @@
 
 #include "fft.h"
 
+#include <prof.h>
+
+// Profiler regions of the FFT stages
+#define FFT_PROF_REGION_2C 0
+#define FFT_PROF_REGION_SC 1
+
 // Single-core FFT
 // DIF Cooley-Tukey algorithm
 // At every iteration, we store indexed
@@ -25,6 +31,7 @@
 void fft_sc(float *s, float *buf, const float *twi, const uint16_t *seq_idx,
             const uint16_t *rev_idx, const unsigned int nfft,
             const unsigned int log2_nfft, const unsigned int cid) {
+  snrt_prof_region_begin(FFT_PROF_REGION_SC);
 
   // Always run in dual-core mode
   const unsigned int dc = 1;
@@ -153,6 +160,7 @@ void fft_sc(float *s, float *buf, const float *twi, const uint16_t *seq_idx,
       asm volatile("vsuxei16.v v12, (%0), v24" ::"r"(im_l_o));
     }
   }
+  snrt_prof_region_end(FFT_PROF_REGION_SC);
 }
 
 // The first log2(n_cores) butterflies are special, then, we fall-back into
@@ -161,6 +169,7 @@ void fft_sc(float *s, float *buf, const float *twi, const uint16_t *seq_idx,
 // implements just the first butterfly stage of a 2-core implementation.
 void fft_2c(const float *s, float *buf, const float *twi,
             const unsigned int nfft, const unsigned int cid) {
+  snrt_prof_region_begin(FFT_PROF_REGION_2C);
   // avl = (nfft/2) / n_cores
   size_t avl = nfft >> 2;
   size_t vl;
@@ -235,4 +244,5 @@ void fft_2c(const float *s, float *buf, const float *twi,
     asm volatile("vse32.v v28, (%0)" ::"r"(im_l_o));
     im_l_o += vl;
   }
+  snrt_prof_region_end(FFT_PROF_REGION_2C);
 }
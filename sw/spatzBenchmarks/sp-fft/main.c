@@ -80,6 +80,9 @@ int main() {
   float *buf_ = buffer + cid * (NFFT >> 1);
   float *twi_ = twiddle + NFFT;
 
+  // Allocate the profiler regions of the kernel outside of the timed section
+  snrt_prof_init();
+
   // Wait for all cores to finish
   snrt_cluster_hw_barrier();
 
@@ -119,8 +122,14 @@ int main() {
 
     printf("\n----- fft on %d samples -----\n", NFFT);
     printf("The execution took %u cycles.\n", timer);
+    benchmark_print_perf(timer);
     printf("The performance is %ld OP/1000cycle (%ld%%o utilization).\n",
            performance, utilization);
+    size_t dram_bytes =
+        (4 * NFFT + 2 * NTWI + NFFT) * sizeof(float) +
+        (log2_nfft + 1) * (NFFT / 4) * sizeof(uint16_t);
+    benchmark_report("sp-fft", 10ull * NFFT * log2_nfft * 6 / 5, 2, dram_bytes,
+                     timer);
 
     // Verify the real part
     for (unsigned int i = 0; i < NFFT; i++) {
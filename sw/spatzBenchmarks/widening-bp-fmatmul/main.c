@@ -120,8 +120,15 @@ int main() {
 
     printf("\n----- (%dx%d) widening bp fmatmul -----\n", gemm_l.M, gemm_l.N);
     printf("The execution took %u cycles.\n", timer);
+    benchmark_print_perf(timer);
     printf("The performance is %ld OP/1000cycle (%ld%%o utilization).\n",
            performance, utilization);
+    size_t dram_bytes =
+        (gemm_l.M * gemm_l.K + gemm_l.K * gemm_l.N + gemm_l.M * gemm_l.N) *
+        sizeof(char);
+    benchmark_report("widening-bp-fmatmul",
+                     2ull * gemm_l.M * gemm_l.N * gemm_l.K, 4, dram_bytes,
+                     timer);
   }
 
   // Wait for all cores to finish
@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+# Copyright 2023 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+#
+# Reader for the binary instruction traces written by the testbench with
+# `+trace_format=bin` or `+trace_format=bin.zst`, see
+# `hw/ip/snitch_test/src/trace_lib.cc` for the format. `read_entries` yields
+# the same entries `gen_trace.py` parses out of a disassembled text trace.
+
+import contextlib
+import shutil
+import struct
+import subprocess
+import sys
+import tempfile
+
+MAGIC = b"SNTRACE\0"
+VERSION = 1
+EXTENSIONS = (".bin", ".bin.zst")
+
+# Fields of a record which are not part of the extras
+HEADER_FIELDS = ("time", "cycle", "priv", "pc", "insn")
+
+STRUCT_FMTS = {1: "B", 2: "H", 4: "I", 8: "Q"}
+
+
+def is_binary_trace(path: str) -> bool:
+    return path.endswith(EXTENSIONS)
+
+
+# Open the trace at `path` as a stream of its uncompressed bytes. Compressed
+# traces are decompressed on the fly, with the `zstandard` module if it is
+# installed and through a `zstd` process otherwise.
+@contextlib.contextmanager
+def open_trace(path: str):
+    if not path.endswith(".zst"):
+        with open(path, "rb") as f:
+            yield f
+        return
+    try:
+        import zstandard
+    except ImportError:
+        zstandard = None
+    if zstandard:
+        with open(path, "rb") as raw:
+            with zstandard.ZstdDecompressor().stream_reader(raw) as f:
+                yield f
+        return
+    proc = subprocess.Popen(["zstd", "-dc", path], stdout=subprocess.PIPE)
+    try:
+        yield proc.stdout
+    except BaseException:
+        proc.kill()
+        proc.wait()
+        raise
+    proc.stdout.close()
+    if proc.wait():
+        raise subprocess.CalledProcessError(proc.returncode, proc.args)
+
+
+def read_exactly(f, size: int) -> bytes:
+    buf = b""
+    while len(buf) < size:
+        chunk = f.read(size - len(buf))
+        if not chunk:
+            break
+        buf += chunk
+    return buf
+
+
+# Parse the header and return the hart ID, the field names and the record
+# layout.
+def read_header(f) -> (int, list, struct.Struct):
+    magic = read_exactly(f, len(MAGIC))
+    if magic != MAGIC:
+        raise ValueError("Not a binary trace")
+    version, hart_id, num_fields = struct.unpack("<III", read_exactly(f, 12))
+    if version != VERSION:
+        raise ValueError("Unsupported trace version {}".format(version))
+    names, fmt = [], "<"
+    for _ in range(num_fields):
+        width, name_len = read_exactly(f, 2)
+        names.append(read_exactly(f, name_len).decode())
+        fmt += STRUCT_FMTS[width]
+    return hart_id, names, struct.Struct(fmt)
+
+
+# Yield every record of the trace at `path` as a dict.
+def read_records(path: str):
+    with open_trace(path) as f:
+        _, names, layout = read_header(f)
+        while True:
+            buf = read_exactly(f, layout.size * 4096)
+            for values in layout.iter_unpack(buf[: len(buf) - len(buf) % layout.size]):
+                yield dict(zip(names, values))
+            if len(buf) < layout.size * 4096:
+                break
+
+
+# Disassemble all distinct instruction words with a single `dasm` process.
+def disassemble(insns: set, dasm: str = "spike-dasm") -> dict:
+    insns = sorted(insns)
+    query = "".join("DASM({:08x})\n".format(insn) for insn in insns)
+    proc = subprocess.run(
+        [dasm], input=query, stdout=subprocess.PIPE, universal_newlines=True, check=True
+    )
+    return dict(zip(insns, proc.stdout.splitlines()))
+
+
+# Yield `(time_info, priv_lvl, pc_str, insn, extras)` tuples as consumed by
+# `gen_trace.annotate_insn`. The trace is read twice: once to collect the
+# instruction words to disassemble and once to emit the entries. Compressed
+# traces are decompressed only once, into a temporary file.
+def read_entries(path: str, dasm: str = "spike-dasm"):
+    if path.endswith(".zst"):
+        with tempfile.NamedTemporaryFile(suffix=".bin") as tmp:
+            with open_trace(path) as f:
+                shutil.copyfileobj(f, tmp)
+            tmp.flush()
+            yield from read_entries(tmp.name, dasm)
+        return
+    insns = disassemble({rec["insn"] for rec in read_records(path)}, dasm)
+    for rec in read_records(path):
+        extras = {k: v for k, v in rec.items() if k not in HEADER_FIELDS}
+        yield (
+            (rec["time"], rec["cycle"]),
+            str(rec["priv"]),
+            "0x{:08x}".format(rec["pc"]),
+            insns[rec["insn"]],
+            extras,
+        )
+
+
+if __name__ == "__main__":
+    # Dump the raw records of a trace
+    for rec in read_records(sys.argv[1]):
+        print(rec)
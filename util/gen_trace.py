@@ -16,6 +16,7 @@ import re
 import math
 import argparse
 import json
+import bintrace
 from ctypes import c_int32, c_uint32
 from collections import deque, defaultdict
 
@@ -46,6 +47,8 @@ PERF_EVAL_KEYS_OMIT = (
     "fpss_fpu_issues",
     "fpss_load_latency",
     "fpss_fpu_latency",
+    "vfu_work",
+    "vl_sum",
 )
 
 # -------------------- Architectural constants and enums  --------------------
@@ -330,6 +333,25 @@ CSR_NAMES = {
 
 PRIV_LVL = {"3": "M", "1": "S", "0": "U"}
 
+# -------------------- Spatz configuration  --------------------
+
+# Defaults match `spatz_cluster.default.hjson`, see `--vlen` and `--n-fpu`
+SPATZ_VLEN = 512
+SPATZ_N_FPU = 4
+# Width of a Spatz FPU, which packs narrower elements SIMD-wise
+SPATZ_ELEN = 64
+
+VSEW = (8, 16, 32, 64)
+VLMUL = (1, 2, 4, 8, None, 1 / 8, 1 / 4, 1 / 2)
+
+VSETVL_REGEX = re.compile(r"^vset(i)?vli?$")
+VLSU_REGEX = re.compile(r"^v[ls](e\d|se\d|[uo]xei\d|\dr|m\.v)")
+VSLDU_REGEX = re.compile(r"^vf?slide")
+# Vector FP instructions performing two FLOPs per element
+VFU_FMA_REGEX = re.compile(r"^vfw?n?m(acc|sac|add|sub)")
+# Vector FP instructions not counted as FLOPs
+VFU_NOFLOP_REGEX = re.compile(r"^vf(w|n)?(mv|cvt|class|sgnj|merge)")
+
 # -------------------- FPU helpers  --------------------
 
 
@@ -408,6 +430,94 @@ def flt_lit(num: int, fmt: int, width: int = 7) -> str:
     return flt_fmt(flt_decode(num, fmt), width)
 
 
+# -------------------- Vector helpers  --------------------
+
+
+def new_vec_info(vlen: int = SPATZ_VLEN) -> dict:
+    # Vector state as last configured by `vset{i}vl{i}`
+    return {"vlen": vlen, "vl": 0, "sew": 64, "lmul": 1, "vl_rd": None}
+
+
+def fmt_lmul(lmul: float) -> str:
+    return "m{}".format(lmul) if lmul >= 1 else "mf{}".format(int(1 / lmul))
+
+
+# Track `vsetvl*` and account a vector instruction offloaded to Spatz.
+# Returns the unit it was issued to and the vector state, if any.
+def annotate_vector(
+    insn: str, extras: dict, vec_info: dict, perf_metrics: list
+) -> str:
+    fields = insn.replace(",", " ").split()
+    if not fields or not fields[0].startswith("v"):
+        return None
+    mnemonic = fields[0]
+    section = perf_metrics[-1]
+    unit = None
+    if VSETVL_REGEX.match(mnemonic):
+        section["vsetvl_issues"] += 1
+        if mnemonic == "vsetvl":
+            vtype = extras["opb"]
+            vec_info["sew"] = VSEW[(vtype >> 3) & 0x7]
+            vec_info["lmul"] = VLMUL[vtype & 0x7] or 1
+        else:
+            for field in fields[3:]:
+                if re.match(r"^e\d+$", field):
+                    vec_info["sew"] = int(field[1:])
+                elif re.match(r"^mf?\d$", field):
+                    n = int(field[-1])
+                    vec_info["lmul"] = 1 / n if field[1] == "f" else n
+        vlmax = int(vec_info["vlen"] * vec_info["lmul"] // vec_info["sew"])
+        if mnemonic == "vsetivli":
+            vec_info["vl"] = min(int(fields[2], 0), vlmax)
+        elif extras["rs1"] != 0:
+            vec_info["vl"] = min(extras["opa"], vlmax)
+        elif extras["rd"] != 0:
+            vec_info["vl"] = vlmax
+        # Spatz answers with the granted vl, which takes precedence
+        vec_info["vl_rd"] = extras["rd"] or None
+        unit = "VCFG"
+    vl, sew = vec_info["vl"], vec_info["sew"]
+    vtype_str = "vl {}, e{}, {}".format(vl, sew, fmt_lmul(vec_info["lmul"]))
+    if unit == "VCFG":
+        return "{} <~~ {}".format(unit, vtype_str)
+    if VLSU_REGEX.match(mnemonic):
+        unit = "VLSU"
+        section["vlsu_issues"] += 1
+        if re.match(r"^v[ls]\dr", mnemonic):
+            nbytes = int(mnemonic[2]) * vec_info["vlen"] // 8
+        elif re.match(r"^v[ls]m\.v", mnemonic):
+            nbytes = (vl + 7) // 8
+        elif "xei" in mnemonic:
+            nbytes = vl * sew // 8
+        else:
+            nbytes = vl * int(re.search(r"e(\d+)", mnemonic).group(1)) // 8
+        section["vlsu_load_bytes" if mnemonic[1] == "l" else "vlsu_store_bytes"] += nbytes
+    elif VSLDU_REGEX.match(mnemonic):
+        unit = "VSLDU"
+        section["vsldu_issues"] += 1
+    else:
+        unit = "VFU"
+        section["vfu_issues"] += 1
+        if mnemonic.startswith("vf") and not VFU_NOFLOP_REGEX.match(mnemonic):
+            flops = 2 if VFU_FMA_REGEX.match(mnemonic) else 1
+            section["vfu_flops"] += flops * vl
+            # FLOPs weighted by the inverse peak throughput at this SEW
+            section["vfu_work"] += flops * vl * sew / SPATZ_ELEN
+    section["vl_sum"] += vl
+    for key, val in (("vl", vl), ("sew", sew), ("lmul", fmt_lmul(vec_info["lmul"]))):
+        hist = section.setdefault(key + "_hist", defaultdict(int))
+        hist[val] += 1
+    return "{} <~~ {}".format(unit, vtype_str)
+
+
+# The vl granted by Spatz for the last `vsetvl*` returns through the
+# accelerator interface
+def retire_vector(extras: dict, vec_info: dict):
+    if extras["retire_acc"] and extras["acc_pid"] == vec_info["vl_rd"]:
+        vec_info["vl"] = extras["acc_pdata_32"]
+        vec_info["vl_rd"] = None
+
+
 # -------------------- Annotation --------------------
 
 
@@ -529,9 +639,20 @@ def annotate_snitch(
     return ", ".join(ret)
 
 
+# Split a disassembled text trace line into `(time_info, priv_lvl, pc_str,
+# insn, extras)`, the latter being `None` for vanilla traces.
+def parse_trace_line(line: str) -> tuple:
+    match = re.search(TRACE_IN_REGEX, line.strip("\n"))
+    if match is None:
+        raise ValueError("Not a valid trace line:\n{}".format(line))
+    time_str, cycle_str, priv_lvl, pc_str, insn, _, extras_str = match.groups()
+    extras = read_annotations(extras_str) if extras_str else None
+    return (int(time_str), int(cycle_str)), priv_lvl, pc_str, insn, extras
+
+
 # noinspection PyTypeChecker
 def annotate_insn(
-    line: str,
+    entry,  # A text trace line or an entry parsed by `parse_trace_line`
     gpr_wb_info: dict,  # One deque (FIFO) per GPR storing start cycles for each GPR WB
     fpr_wb_info:
     # One deque (FIFO) per FPR storing start cycles and formats for each FPR WB
@@ -543,21 +664,19 @@ def annotate_insn(
     annot_fseq_offl: bool = False,  # Annotate whenever core offloads to CPU on own line
     force_hex_addr: bool = True,
     permissive: bool = True,
+    vec_info: dict = None,  # Vector state to account Spatz instructions against
 ) -> (
     str,
     tuple,
     bool,
 ):  # Return time info, whether trace line contains no info, and fseq_len
-    match = re.search(TRACE_IN_REGEX, line.strip("\n"))
-    if match is None:
-        raise ValueError("Not a valid trace line:\n{}".format(line))
-    time_str, cycle_str, priv_lvl, pc_str, insn, _, extras_str = match.groups()
-    time_info = (int(time_str), int(cycle_str))
+    if isinstance(entry, str):
+        entry = parse_trace_line(entry)
+    time_info, priv_lvl, pc_str, insn, extras = entry
     show_time_info = dupl_time_info or time_info != last_time_info
     time_info_strs = tuple((str(elem) if show_time_info else "") for elem in time_info)
     # Annotated trace
-    if extras_str:
-        extras = read_annotations(extras_str)
+    if extras is not None:
         # Annotate snitch
         if extras["source"] == TRACE_SRCES["snitch"]:
             annot = annotate_snitch(
@@ -570,6 +689,11 @@ def annotate_insn(
                 force_hex_addr,
                 permissive,
             )
+            vec_annot = None
+            if vec_info is not None:
+                retire_vector(extras, vec_info)
+                if extras["fpu_offload"]:
+                    vec_annot = annotate_vector(insn, extras, vec_info, perf_metrics)
             if extras["fpu_offload"]:
                 perf_metrics[-1]["snitch_fseq_offloads"] += 1
                 fseq_info["fpss_pcs"].appendleft(
@@ -577,7 +701,10 @@ def annotate_insn(
                 )
                 if extras["is_seq_insn"]:
                     fseq_info["fseq_pcs"].appendleft(pc_str)
-            if extras["stall"] or extras["fpu_offload"]:
+            if vec_annot:
+                # Vector instructions are only traced by the core
+                annot = ", ".join(a for a in (annot, vec_annot) if a)
+            elif extras["stall"] or extras["fpu_offload"]:
                 insn, pc_str = ("", "")
             else:
                 perf_metrics[-1]["snitch_issues"] += 1
@@ -612,6 +739,29 @@ def safe_div(dividend, divisor, zero_div=0):
     return dividend / divisor if divisor else zero_div
 
 
+# Derive the vector metrics of each section from its counts
+def eval_vector_metrics(perf_metrics: list, n_fpu: int = SPATZ_N_FPU):
+    for section in perf_metrics:
+        vec_issues = sum(
+            section[key] for key in ("vfu_issues", "vlsu_issues", "vsldu_issues")
+        )
+        if not vec_issues:
+            continue
+        cycles = (section["end"] or 0) - (section["start"] or 0)
+        section["vsetvl_overhead"] = safe_div(
+            section["vsetvl_issues"], vec_issues + section["vsetvl_issues"]
+        )
+        section["avg_vl"] = safe_div(section["vl_sum"], vec_issues)
+        section["vfu_flop_per_cycle"] = safe_div(section["vfu_flops"], cycles)
+        # Each FPU performs one FMA on ELEN/SEW elements per cycle
+        section["vfu_fpu_utilization"] = safe_div(
+            section["vfu_work"], 2 * n_fpu * cycles
+        )
+        section["vlsu_bytes_per_cycle"] = safe_div(
+            section["vlsu_load_bytes"] + section["vlsu_store_bytes"], cycles
+        )
+
+
 def fmt_perf_metrics(perf_metrics: list, idx: int, omit_keys: bool = True):
     ret = [
         "Performance metrics for section {} @ ({}, {}):".format(
@@ -623,6 +773,8 @@ def fmt_perf_metrics(perf_metrics: list, idx: int, omit_keys: bool = True):
             continue
         if val is None:
             val_str = str(None)
+        elif isinstance(val, dict):
+            val_str = " ".join("{}:{}".format(k, v) for k, v in sorted(val.items()))
         elif isinstance(val, float):
             val_str = flt_fmt(val, 4)
         else:
@@ -631,6 +783,76 @@ def fmt_perf_metrics(perf_metrics: list, idx: int, omit_keys: bool = True):
     return "\n".join(ret)
 
 
+# -------------------- Trace iteration --------------------
+
+
+def new_trace_state(vlen: int = SPATZ_VLEN) -> dict:
+    perf_metrics = [
+        defaultdict(int)
+    ]  # all values initially 0, also 'start' time of measurement 0
+    perf_metrics[0]["start"] = None
+    return {
+        "time_info": None,
+        "gpr_wb_info": defaultdict(deque),
+        "fpr_wb_info": defaultdict(deque),
+        "fseq_info": {
+            "curr_sec": 0,
+            "fpss_pcs": deque(),
+            "fseq_pcs": deque(),
+            "cfg_buf": deque(),
+            "curr_cfg": None,
+        },
+        "perf_metrics": perf_metrics,
+        "vec_info": new_vec_info(vlen),
+    }
+
+
+# Entries of the trace at `path`: disassembled text lines or, for binary
+# traces, parsed records.
+def read_trace(path: str, dasm: str = "spike-dasm"):
+    if bintrace.is_binary_trace(path):
+        return bintrace.read_entries(path, dasm)
+    infile = sys.stdin if path == "-" else open(path, "r")
+    return (line for line in infile if line)
+
+
+# Yield the annotated lines of a trace, accumulating into `state`.
+def annotate_trace(
+    entries,
+    state: dict,
+    annot_fseq_offl: bool = False,
+    force_hex_addr: bool = True,
+    permissive: bool = True,
+):
+    perf_metrics = state["perf_metrics"]
+    for entry in entries:
+        ann_insn, state["time_info"], empty = annotate_insn(
+            entry,
+            state["gpr_wb_info"],
+            state["fpr_wb_info"],
+            state["fseq_info"],
+            perf_metrics,
+            False,
+            state["time_info"],
+            annot_fseq_offl,
+            force_hex_addr,
+            permissive,
+            state["vec_info"],
+        )
+        if perf_metrics[0]["start"] is None and state["time_info"]:
+            perf_metrics[0]["start"] = state["time_info"][1]
+        if not empty:
+            yield ann_insn
+    perf_metrics[-1]["end"] = state["time_info"][1]
+
+
+# Stream the annotated lines of the trace at `path`, as written by `main`.
+# Lets other tools consume binary traces directly.
+def annotated_lines(path: str, dasm: str = "spike-dasm"):
+    for line in annotate_trace(read_trace(path, dasm), new_trace_state()):
+        yield line + "\n"
+
+
 # -------------------- Main --------------------
 
 
@@ -642,9 +864,25 @@ def main():
         "infile",
         metavar="infile.dasm",
         nargs="?",
-        type=argparse.FileType("r"),
-        default=sys.stdin,
-        help="A matching ASCII signal dump",
+        default="-",
+        help="A matching ASCII signal dump or a binary trace (.bin, .bin.zst)",
+    )
+    parser.add_argument(
+        "--vlen",
+        type=int,
+        default=SPATZ_VLEN,
+        help="Vector register length of Spatz in bits",
+    )
+    parser.add_argument(
+        "--n-fpu",
+        type=int,
+        default=SPATZ_N_FPU,
+        help="Number of FPUs per Spatz, the peak is one FMA per FPU and cycle",
+    )
+    parser.add_argument(
+        "--dasm",
+        default="spike-dasm",
+        help="Disassembler used for binary traces",
     )
     parser.add_argument(
         "-o",
@@ -680,44 +918,21 @@ def main():
     )
 
     args = parser.parse_args()
-    line_iter = iter(args.infile.readline, b"")
     # Prepare stateful data structures
-    time_info = None
-    gpr_wb_info = defaultdict(deque)
-    fpr_wb_info = defaultdict(deque)
-    fseq_info = {
-        "curr_sec": 0,
-        "fpss_pcs": deque(),
-        "fseq_pcs": deque(),
-        "cfg_buf": deque(),
-        "curr_cfg": None,
-    }
-    perf_metrics = [
-        defaultdict(int)
-    ]  # all values initially 0, also 'start' time of measurement 0
-    perf_metrics[0]["start"] = None
-    # Parse input line by line
-    for line in line_iter:
-        if line:
-            ann_insn, time_info, empty = annotate_insn(
-                line,
-                gpr_wb_info,
-                fpr_wb_info,
-                fseq_info,
-                perf_metrics,
-                False,
-                time_info,
-                args.offl,
-                not args.saddr,
-                args.permissive,
-            )
-            if perf_metrics[0]["start"] is None:
-                perf_metrics[0]["start"] = time_info[1]
-            if not empty:
-                print(ann_insn)
-        else:
-            break  # Nothing more in pipe, EOF
-    perf_metrics[-1]["end"] = time_info[1]
+    state = new_trace_state(args.vlen)
+    fpr_wb_info = state["fpr_wb_info"]
+    fseq_info = state["fseq_info"]
+    perf_metrics = state["perf_metrics"]
+    # Parse input entry by entry
+    for ann_insn in annotate_trace(
+        read_trace(args.infile, args.dasm),
+        state,
+        args.offl,
+        not args.saddr,
+        args.permissive,
+    ):
+        print(ann_insn)
+    eval_vector_metrics(perf_metrics, args.n_fpu)
     # Emit metrics
     print("\n## Performance metrics")
     for idx in range(len(perf_metrics)):
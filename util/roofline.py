@@ -0,0 +1,307 @@
+#!/usr/bin/env python3
+# Copyright 2023 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+# This script collects the `[roofline]` lines printed by `benchmark_report()`
+# of the spatzBenchmarks and places the kernels on the roofline of a cluster
+# configuration. The peak compute follows from the number of cores and FPUs
+# of the configuration, the TCDM bandwidth from its banks and core ports, and
+# the DRAM bandwidth from the width of the DMA.
+#
+# The TCDM intensity relates the operations to the bytes the cores access in
+# the TCDM during the kernel. The DRAM intensity relates them to the data the
+# benchmark moves with the DMA, i.e., it shows whether a kernel would be bound
+# by the DMA if it streamed its data instead of staging it beforehand. The
+# TCDM bytes are only reported by benchmarks built with
+# `-DSPATZ_BENCHMARK_PERF=tcdm`, as `make roofline` in
+# `hw/system/spatz_cluster` does. Running benchmarks built without them is
+# an error; logs without them are analyzed without the TCDM roof.
+#
+# Either run all benchmarks of `sw/spatzBenchmarks/CMakeLists.txt` on a
+# simulator or read the output of earlier runs:
+#     roofline.py --sim bin/spatz_cluster.vlt \
+#                 --build-dir sw/build-roofline/spatzBenchmarks -o roofline.svg
+#     roofline.py logs/*.txt
+
+import os
+import re
+import sys
+import math
+import hjson
+import argparse
+import tempfile
+import subprocess
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+DEFAULT_CFG = os.path.join(
+    ROOT, "hw/system/spatz_cluster/cfg/spatz_cluster.default.hjson")
+BENCHMARKS = os.path.join(ROOT, "sw/spatzBenchmarks/CMakeLists.txt")
+
+REPORT_REGEX = re.compile(r"\[roofline\]((?: \w+=\S+)+)")
+TEST_REGEX = re.compile(
+    r"^\s*add_spatz_test_(?:one|two|three)Param\((\S+)\s+\S+((?:\s+\w+)+)\s*\)")
+
+NO_TCDM_BYTES = ("no TCDM bytes reported by {}; build the benchmarks with "
+                 "-DSPATZ_BENCHMARK_PERF=tcdm, e.g., with `make roofline`")
+
+ROW_FMT = "{:<36} {:>12} {:>10} {:>8} {:>7} {:>9} {:>9}  {:<8}"
+
+parser = argparse.ArgumentParser("roofline", allow_abbrev=True)
+parser.add_argument(
+    "logs",
+    metavar="<log>",
+    nargs="*",
+    help="Output of earlier benchmark runs",
+)
+parser.add_argument(
+    "-c",
+    "--cfg",
+    default=DEFAULT_CFG,
+    help="Cluster configuration (default: %(default)s)",
+)
+parser.add_argument(
+    "--sim",
+    help="Simulator to run the benchmarks on",
+)
+parser.add_argument(
+    "--build-dir",
+    help="Directory holding the benchmark binaries, e.g., "
+    "sw/build-roofline/spatzBenchmarks",
+)
+parser.add_argument(
+    "-t",
+    "--timeout",
+    type=int,
+    default=3600,
+    help="Timeout of a single simulation in seconds",
+)
+parser.add_argument(
+    "-o",
+    "--output",
+    help="Write the roofline chart as an SVG image to this file",
+)
+
+
+class Cluster:
+    def __init__(self, path):
+        with open(path) as f:
+            cfg = hjson.load(f)["cluster"]
+        self.name = os.path.basename(path).split(".hjson")[0]
+        self.cores = len(cfg["cores"])
+        self.n_fpu = cfg["n_fpu"]
+        self.vlen = cfg["vlen"]
+        word = cfg["data_width"] // 8
+        # Every core has a TCDM port per FPU and one for Snitch.
+        ports = self.cores * (self.n_fpu + 1)
+        self.tcdm_bw = min(cfg["tcdm"]["banks"], ports) * word
+        self.dram_bw = cfg["dma_data_width"] // 8
+
+    def peak(self, simd):
+        """Operations per cycle, counting an FMA as two."""
+        return 2 * self.cores * self.n_fpu * simd
+
+
+def benchmark_binaries(build_dir):
+    """The binaries of all benchmarks in the CMakeLists.txt."""
+    with open(BENCHMARKS) as f:
+        for line in f:
+            m = TEST_REGEX.match(line)
+            if not m:
+                continue
+            params = m.group(2).split()
+            name = m.group(1) + "".join(
+                "_{}{}".format(p, v) for p, v in zip("MNK", params))
+            yield os.path.join(build_dir, "test-spatzBenchmarks-" + name)
+
+
+def run(sim, binary, timeout):
+    # Run in a scratch directory to not clobber the logs of earlier runs.
+    with tempfile.TemporaryDirectory(prefix="roofline-") as cwd:
+        proc = subprocess.run(
+            [sim, binary],
+            cwd=cwd,
+            stdout=subprocess.PIPE,
+            stderr=subprocess.STDOUT,
+            universal_newlines=True,
+            timeout=timeout,
+        )
+    if proc.returncode != 0:
+        sys.stderr.write(proc.stdout)
+        raise RuntimeError("{} failed on {} with exit code {}".format(
+            sim, binary, proc.returncode))
+    return proc.stdout
+
+
+def parse(name, output):
+    """The reports in `output`, named after the kernel unless `name` is set.
+    Several reports of the same binary are told apart by their kernel."""
+    reports = []
+    for m in REPORT_REGEX.finditer(output):
+        fields = dict(f.split("=", 1) for f in m.group(1).split())
+        report = {k: int(v) for k, v in fields.items() if k != "kernel"}
+        report["kernel"] = fields["kernel"]
+        report["name"] = name or fields["kernel"]
+        reports.append(report)
+    if name and len(reports) > 1:
+        for report in reports:
+            report["name"] = "{}:{}".format(name, report["kernel"])
+    return reports
+
+
+def analyze(cluster, r):
+    peak = cluster.peak(r["simd"])
+    r["perf"] = r["ops"] / r["cycles"] if r["cycles"] else 0
+    r["util"] = r["perf"] / peak
+    if "tcdm_bytes" not in r:
+        r["i_tcdm"] = math.nan
+    elif r["tcdm_bytes"]:
+        r["i_tcdm"] = r["ops"] / r["tcdm_bytes"]
+    else:
+        r["i_tcdm"] = math.inf
+    r["i_dram"] = r["ops"] / r["dram_bytes"] if r["dram_bytes"] else math.inf
+    # The roof with the lowest attainable performance bounds the kernel.
+    roofs = {
+        "compute": peak,
+        "dram": cluster.dram_bw * r["i_dram"],
+    }
+    if not math.isnan(r["i_tcdm"]):
+        roofs["tcdm"] = cluster.tcdm_bw * r["i_tcdm"]
+    r["bound"] = min(roofs, key=roofs.get)
+
+
+def print_table(cluster, reports):
+    print("{}: {} cores, {} FPUs per core, VLEN {}, TCDM {} B/cycle, "
+          "DMA {} B/cycle".format(cluster.name, cluster.cores, cluster.n_fpu,
+                                  cluster.vlen, cluster.tcdm_bw,
+                                  cluster.dram_bw))
+    print(ROW_FMT.format("benchmark", "ops", "cycles", "ops/cyc", "util",
+                         "I_tcdm", "I_dram", "bound"))
+    for r in reports:
+        print(ROW_FMT.format(
+            r["name"], r["ops"], r["cycles"], "{:.2f}".format(r["perf"]),
+            "{:.1%}".format(r["util"]),
+            "-" if math.isnan(r["i_tcdm"]) else "{:.3f}".format(r["i_tcdm"]),
+            "{:.3f}".format(r["i_dram"]), r["bound"]))
+
+
+def write_svg(path, cluster, reports):
+    w, h, left, bottom, top, right = 720, 480, 60, 40, 20, 180
+    simds = sorted({r["simd"] for r in reports})
+    xs = [v for r in reports for v in (r["i_tcdm"], r["i_dram"])
+          if 0 < v < math.inf]
+    ridge = cluster.peak(simds[-1]) / min(cluster.tcdm_bw, cluster.dram_bw)
+    x_lo = 10**math.floor(math.log10(min(xs + [0.1])))
+    x_hi = 10**math.ceil(math.log10(max(xs + [ridge * 4])))
+    y_lo = 10**math.floor(math.log10(min(
+        [r["perf"] for r in reports if r["perf"] > 0] + [0.1])))
+    y_hi = 10**math.ceil(math.log10(cluster.peak(simds[-1]) * 2))
+
+    def px(x):
+        x = min(max(x, x_lo), x_hi)
+        return left + (w - left - right) * math.log(x / x_lo) / math.log(
+            x_hi / x_lo)
+
+    def py(y):
+        y = min(max(y, y_lo), y_hi)
+        return h - bottom - (h - bottom - top) * math.log(
+            y / y_lo) / math.log(y_hi / y_lo)
+
+    out = [
+        '<svg xmlns="http://www.w3.org/2000/svg" width="{}" height="{}" '
+        'font-family="sans-serif" font-size="11">'.format(w, h),
+        '<rect x="{}" y="{}" width="{}" height="{}" fill="none" '
+        'stroke="black"/>'.format(left, top, w - left - right,
+                                  h - top - bottom),
+    ]
+    # Decades on both axes
+    x = x_lo
+    while x <= x_hi:
+        out.append('<text x="{:.1f}" y="{}" text-anchor="middle">{:g}</text>'
+                   .format(px(x), h - bottom + 14, x))
+        x *= 10
+    y = y_lo
+    while y <= y_hi:
+        out.append('<text x="{}" y="{:.1f}" text-anchor="end">{:g}</text>'
+                   .format(left - 4, py(y) + 4, y))
+        y *= 10
+    out.append('<text x="{}" y="{}" text-anchor="middle">operational '
+               'intensity [ops/B]</text>'.format((w - right + left) / 2,
+                                                 h - 8))
+    out.append('<text x="14" y="{}" transform="rotate(-90 14 {})" '
+               'text-anchor="middle">performance [ops/cycle]</text>'.format(
+                   (h - bottom + top) / 2, (h - bottom + top) / 2))
+    # Roofs of every precision and memory level
+    for simd in simds:
+        peak = cluster.peak(simd)
+        for bw, color in ((cluster.tcdm_bw, "steelblue"),
+                          (cluster.dram_bw, "darkorange")):
+            knee = peak / bw
+            out.append(
+                '<polyline fill="none" stroke="{}" points="{:.1f},{:.1f} '
+                '{:.1f},{:.1f} {:.1f},{:.1f}"/>'.format(
+                    color, px(x_lo), py(bw * x_lo), px(knee), py(peak),
+                    px(x_hi), py(peak)))
+        out.append('<text x="{:.1f}" y="{:.1f}">peak x{} ({} ops/cycle)'
+                   '</text>'.format(px(x_hi) - 130, py(peak) - 3, simd, peak))
+    # Kernels at their TCDM (filled) and DRAM (hollow) intensity
+    for i, r in enumerate(reports):
+        y = py(r["perf"])
+        for v, fill in ((r["i_tcdm"], "steelblue"), (r["i_dram"], "white")):
+            if 0 < v < math.inf:
+                out.append(
+                    '<circle cx="{:.1f}" cy="{:.1f}" r="4" fill="{}" '
+                    'stroke="black"><title>{}: {:.3f} ops/B, {:.2f} '
+                    'ops/cycle</title></circle>'.format(
+                        px(v), y, fill, r["name"], v, r["perf"]))
+        if 0 < r["i_tcdm"] < math.inf:
+            out.append('<text x="{:.1f}" y="{:.1f}">{}</text>'.format(
+                px(r["i_tcdm"]) + 6, y - 4, i))
+        out.append('<text x="{}" y="{}">{}: {}</text>'.format(
+            w - right + 10, top + 12 + 14 * i, i, r["name"]))
+    legend_y = top + 12 + 14 * len(reports) + 10
+    out.append('<text x="{}" y="{}" fill="steelblue">TCDM ({} B/cycle)'
+               '</text>'.format(w - right + 10, legend_y, cluster.tcdm_bw))
+    out.append('<text x="{}" y="{}" fill="darkorange">DMA ({} B/cycle)'
+               '</text>'.format(w - right + 10, legend_y + 14,
+                                cluster.dram_bw))
+    out.append("</svg>")
+    with open(path, "w") as f:
+        f.write("\n".join(out) + "\n")
+
+
+def main():
+    args = parser.parse_args()
+    cluster = Cluster(args.cfg)
+
+    reports = []
+    if args.sim:
+        if not args.build_dir:
+            parser.error("--sim needs --build-dir")
+        for binary in benchmark_binaries(args.build_dir):
+            name = os.path.basename(binary).split("test-spatzBenchmarks-")[-1]
+            print("Running {}".format(name), file=sys.stderr)
+            runs = parse(name, run(args.sim, binary, args.timeout))
+            if any("tcdm_bytes" not in r for r in runs):
+                parser.error(NO_TCDM_BYTES.format(name))
+            reports += runs
+    for log in args.logs:
+        with open(log) as f:
+            reports += parse(None, f.read())
+    if not reports:
+        parser.error("no [roofline] reports found")
+    missing = [r["name"] for r in reports if "tcdm_bytes" not in r]
+    if missing:
+        print("warning: " + NO_TCDM_BYTES.format(", ".join(missing)) +
+              ", leaving out their TCDM roof", file=sys.stderr)
+
+    for r in reports:
+        analyze(cluster, r)
+    print_table(cluster, reports)
+    if args.output:
+        write_svg(args.output, cluster, reports)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+# Copyright 2023 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+# This script runs a set of binaries on one or more simulator flavours and
+# reports the simulation speed, i.e., the simulated cycles per wall-clock
+# second, of each run as well as the aggregate speed of each flavour.
+# Example:
+#     simbench.py --sim vlt=bin/spatz_cluster.vlt \
+#                 --sim vlt-mt=bin/spatz_cluster.vlt-mt \
+#                 sw/build/spatzBenchmarks/test-spatzBenchmarks-dp-faxpy_M1024
+
+import os
+import re
+import sys
+import time
+import argparse
+import tempfile
+import subprocess
+
+# Printed by the Verilator testbench at the end of the simulation
+TB_SPEED_REGEX = r"\[TB\] Simulated (\d+) cycles in ([\d.]+) s"
+
+ROW_FMT = "{:<44} {:<10} {:>12} {:>10} {:>10}"
+
+parser = argparse.ArgumentParser("simbench", allow_abbrev=True)
+parser.add_argument(
+    "binaries",
+    metavar="<binary>",
+    nargs="+",
+    help="The binaries to simulate",
+)
+parser.add_argument(
+    "--sim",
+    metavar="<name>=<path>",
+    action="append",
+    required=True,
+    help="A simulator flavour to benchmark, can be given multiple times",
+)
+parser.add_argument(
+    "-t",
+    "--timeout",
+    type=int,
+    default=3600,
+    help="Timeout of a single simulation in seconds",
+)
+
+
+def run(sim, binary, timeout):
+    # Run in a scratch directory to not clobber the logs of earlier runs.
+    with tempfile.TemporaryDirectory(prefix="simbench-") as cwd:
+        start = time.monotonic()
+        proc = subprocess.run(
+            [sim, binary],
+            cwd=cwd,
+            stdout=subprocess.PIPE,
+            stderr=subprocess.STDOUT,
+            universal_newlines=True,
+            timeout=timeout,
+        )
+        wall = time.monotonic() - start
+    if proc.returncode != 0:
+        sys.stderr.write(proc.stdout)
+        raise RuntimeError("{} failed on {} with exit code {}".format(
+            sim, binary, proc.returncode))
+    match = re.search(TB_SPEED_REGEX, proc.stdout)
+    if not match:
+        raise RuntimeError("{} did not report its simulation speed".format(sim))
+    # Prefer the testbench's own measurement, which excludes the startup.
+    return int(match.group(1)), float(match.group(2)) or wall
+
+
+def main():
+    args = parser.parse_args()
+    sims = []
+    for s in args.sim:
+        name, _, path = s.partition("=")
+        if not path:
+            parser.error("expected <name>=<path>, got {}".format(s))
+        sims.append((name, os.path.abspath(path)))
+    binaries = [os.path.abspath(b) for b in args.binaries]
+
+    print(ROW_FMT.format("binary", "flavour", "cycles", "time [s]", "kHz"))
+    totals = {name: [0, 0.0] for name, _ in sims}
+    for binary in binaries:
+        for name, path in sims:
+            cycles, wall = run(path, binary, args.timeout)
+            totals[name][0] += cycles
+            totals[name][1] += wall
+            print(ROW_FMT.format(
+                os.path.basename(binary)[-44:], name, cycles,
+                "{:.2f}".format(wall), "{:.1f}".format(cycles / wall / 1e3)))
+            sys.stdout.flush()
+
+    print()
+    base = None
+    for name, _ in sims:
+        cycles, wall = totals[name]
+        speed = cycles / wall
+        base = base or speed
+        print("{:<10} {:>10.1f} kHz  {:>5.2f}x".format(name, speed / 1e3,
+                                                       speed / base))
+
+
+if __name__ == "__main__":
+    main()
@@ -22,10 +22,17 @@
 import sys
 import os
 import re
-from functools import lru_cache
+from itertools import islice
+from multiprocessing import Pool
+import shutil
+import subprocess
 import argparse
 from termcolor import colored
 
+# Binary traces are converted by `gen_trace.py`
+sys.path.append(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+import gen_trace  # noqa: E402
+
 # Argument parsing
 parser = argparse.ArgumentParser("annotate", allow_abbrev=True)
 parser.add_argument(
@@ -72,7 +79,22 @@ parser.add_argument(
     nargs="?",
     type=int,
     default=-1,
-    help="Last line to parse",
+    help="Last line to parse, all by default",
+)
+parser.add_argument(
+    "-j",
+    "--jobs",
+    metavar="<n>",
+    type=int,
+    default=1,
+    help="Annotate chunks of a text trace in <n> parallel processes",
+)
+parser.add_argument(
+    "--dasm",
+    metavar="<path>",
+    nargs="?",
+    default="spike-dasm",
+    help="Disassembler used for binary traces (.bin, .bin.zst)",
 )
 parser.add_argument("-q", "--quiet", action="store_true", help="Quiet output")
 
@@ -92,20 +114,53 @@ if not quiet:
     print("diff:", diff, file=sys.stderr)
     print("addr2line:", addr2line, file=sys.stderr)
 
-of = open(output, "w")
-
 if not quiet:
     print(f" annotating: {output}    ", end="")
 
-# buffer source files
-src_files = {}
-trace_start_col = -1
 
+# A single `addr2line` process per worker resolves all addresses, which are
+# sent in batches through its standard input.
+class Addr2Line:
+    # Addresses per batch, keeps the query well below the pipe capacity
+    BATCH = 1024
 
-@lru_cache(maxsize=1024)
-def adr2line(addr):
-    cmd = f"{addr2line} -e {elf} -f -i {addr:x}"
-    return os.popen(cmd).read().split("\n")
+    def __init__(self, addr2line, elf):
+        self.proc = subprocess.Popen(
+            [addr2line, "-e", elf, "-f", "-i", "-a"],
+            stdin=subprocess.PIPE,
+            stdout=subprocess.PIPE,
+            universal_newlines=True,
+        )
+        self.cache = {}
+
+    # Resolve all new addresses of `addrs`. Every answer starts with the
+    # queried address; a trailing sentinel query delimits the last one.
+    def resolve(self, addrs):
+        new = sorted(set(addrs) - self.cache.keys())
+        for i in range(0, len(new), self.BATCH):
+            batch = new[i : i + self.BATCH]
+            self.proc.stdin.write("".join(f"{addr:x}\n" for addr in batch) + "0\n")
+            self.proc.stdin.flush()
+            answers = []
+            while len(answers) <= len(batch):
+                line = self.proc.stdout.readline()
+                if not line:
+                    raise RuntimeError(f"{self.proc.args[0]} exited unexpectedly")
+                line = line.rstrip("\n")
+                if re.match(r"^0x[0-9a-fA-F]+$", line):
+                    answers.append([])
+                elif answers and line:
+                    answers[-1].append(line)
+            self.cache.update(zip(batch, answers))
+
+    def __call__(self, addr):
+        if addr not in self.cache:
+            self.resolve([addr])
+        return self.cache[addr]
+
+    def close(self):
+        self.proc.stdin.close()
+        self.proc.wait()
 
 
 # helper functions to parse addr2line output
@@ -179,22 +234,33 @@ def matching_source_line(cstack1, cstack2):
         matched_src_line = cstack1[-1][2] == cstack2[-1][2]
     except IndexError:
         matched_src_line = False
-    matched_call_stack = matching_call_stack_levels(cstack1, cstack2) == len(
-        next_call_stack
-    )
+    matched_call_stack = matching_call_stack_levels(cstack1, cstack2) == len(cstack1)
     return matched_src_line and matched_call_stack
 
 
-def dump_hunk(hunk_tstart, hunk_sstart, hunk_trace, hunk_source):
+def dump_hunk(of, hunk_tstart, hunk_sstart, hunk_trace, hunk_source):
     hunk_tlen = len(hunk_trace.splitlines())
     hunk_slen = len(hunk_source.splitlines())
     hunk_header = f"@@ -{hunk_tstart},{hunk_tlen} +{hunk_sstart},{hunk_slen} @@\n"
     of.write(f"{hunk_header}{hunk_trace}{hunk_source}")
 
 
-# core functionality
-with open(trace, "r") as f:
-
+# Address of a trace line and the column the trace starts at, or `None`
+def parse_addr(line):
+    try:
+        addr_str = re.split(r" +", line.strip())[3]
+        return int(addr_str, base=16), line.find(addr_str)
+    except (ValueError, IndexError):
+        return None
+
+
+# Annotate `lines` into `of`. Lines are processed in batches, whose addresses
+# are resolved at once.
+def annotate(lines, of, progress=None, batch_lines=4096):
+    a2l = Addr2Line(addr2line, elf)
+    # buffer source files
+    src_files = {}
+    trace_start_col = -1
     # get modified timestamp of trace to compare with source files
     trace_timestamp = os.path.getmtime(trace)
 
@@ -207,112 +273,175 @@ with open(trace, "r") as f:
         hunk_tstart = 1
         hunk_sstart = 1
 
-    trace_lines = f.readlines()[args.start : args.end]
-    tot_lines = len(trace_lines)
-    last_prog = 0
-    for lino, line in enumerate(trace_lines):
-
-        # RTL traces might not contain a PC on each line
-        try:
-            addr_str = re.split(r" +", line.strip())[3]
-            addr = int(addr_str, base=16)
+    lines = iter(lines)
+    while True:
+        batch = list(islice(lines, batch_lines))
+        if not batch:
+            break
+        addrs = [parse_addr(line) for line in batch]
+        a2l.resolve(addr[0] for addr in addrs if addr)
+        for line, addr in zip(batch, addrs):
+
+            # RTL traces might not contain a PC on each line
+            if addr is None:
+                if diff:
+                    hunk_trace += f"-{line[trace_start_col:]}"
+                else:
+                    of.write(f"      {line[trace_start_col:]}")
+                continue
+            addr, col = addr
             if trace_start_col < 0:
-                trace_start_col = line.find(addr_str)
-        except (ValueError, IndexError):
+                trace_start_col = col
+
+            ret = a2l(addr)
+
+            funs = ret[::2]
+            file_paths = [a2l_file_path(x) for x in ret[1::2]]
+            file_names = [a2l_file_name(x) for x in ret[1::2]]
+            file_lines = [a2l_file_line(x) for x in ret[1::2]]
+            # Assemble annotation string
+            if len(funs):
+                annot = f"#; {funs[0]} ({file_names[0]}:{file_lines[0]})"
+                for fun, file_name, file_line in zip(
+                    funs[1:], file_names[1:], file_lines[1:]
+                ):
+                    annot = f"{annot}\n#;  in {fun} ({file_name}:{file_line})"
+
+            # Get source of last file and print the line
+            src_fname = file_paths[0]
+            if src_fname not in src_files.keys():
+                try:
+                    # Issue warning if source was modified after trace
+                    src_timestamp = os.path.getmtime(src_fname)
+                    if src_timestamp >= trace_timestamp:
+                        print(
+                            colored("Warning:", "yellow"),
+                            f"{src_fname} has been edited since the trace was generated",
+                        )
+
+                    with open(src_fname, "r") as src_f:
+                        src_files[src_fname] = [x.strip() for x in src_f.readlines()]
+                except OSError:
+                    src_files[src_fname] = None
+            if src_files[src_fname] is not None:
+                src_line = src_files[src_fname][file_lines[0] - 1]
+                annot = f"{annot}\n#;  {src_line}"
+
+            # Print diff
             if diff:
+                # Compare current and previous call stacks
+                next_call_stack = assemble_call_stack(funs, file_paths, file_lines)
+                matching_cstack_levels = matching_call_stack_levels(
+                    next_call_stack, call_stack
+                )
+                matching_src_line = matching_source_line(next_call_stack, call_stack)
+
+                # If this instruction does not map to the same evaluation of the source line
+                # of the last instruction, we finalize and dump the previous hunk
+                if hunk_trace and not matching_src_line:
+                    dump_hunk(of, hunk_tstart, hunk_sstart, hunk_trace, hunk_source)
+                    # Initialize next hunk
+                    hunk_tstart += len(hunk_trace.splitlines())
+                    hunk_sstart += len(hunk_source.splitlines())
+                    hunk_trace = ""
+                    hunk_source = ""
+
+                # Update state for next iteration
+                call_stack = next_call_stack
+
+                # Assemble source part of hunk
+                if len(funs) and src_files[src_fname]:
+                    for i, call in enumerate(call_stack):
+                        if i >= matching_cstack_levels:
+                            hunk_source += f"+{format_call(i, call)}"
+                    if not matching_src_line:
+                        indentation = "  " * (len(call_stack) - 1)
+                        hunk_source += f"+{indentation}{file_lines[0]}: {src_line}\n"
+
+                # Assemble trace part of hunk
                 hunk_trace += f"-{line[trace_start_col:]}"
+
+            # Default: print trace interleaved with source annotations
             else:
+                if len(annot) and annot != last:
+                    of.write(annot + "\n")
                 of.write(f"      {line[trace_start_col:]}")
-            continue
-
-        addr_hex = f"{addr:x}"
-        ret = adr2line(addr)
-
-        funs = ret[::2]
-        file_paths = [a2l_file_path(x) for x in ret[1::2]]
-        file_names = [a2l_file_name(x) for x in ret[1::2]]
-        file_lines = [a2l_file_line(x) for x in ret[1::2]]
-        # Assemble annotation string
-        if len(funs):
-            annot = f"#; {funs[0]} ({file_names[0]}:{file_lines[0]})"
-            for fun, file_name, file_line in zip(
-                funs[1:], file_names[1:], file_lines[1:]
-            ):
-                annot = f"{annot}\n#;  in {fun} ({file_name}:{file_line})"
-
-        # Get source of last file and print the line
-        src_fname = file_paths[0]
-        if src_fname not in src_files.keys():
-            try:
-                # Issue warning if source was modified after trace
-                src_timestamp = os.path.getmtime(src_fname)
-                if src_timestamp >= trace_timestamp:
-                    print(
-                        colored("Warning:", "yellow"),
-                        f"{src_fname} has been edited since the trace was generated",
-                    )
-
-                with open(src_fname, "r") as src_f:
-                    src_files[src_fname] = [x.strip() for x in src_f.readlines()]
-            except OSError:
-                src_files[src_fname] = None
-        if src_files[src_fname] is not None:
-            src_line = src_files[src_fname][file_lines[0] - 1]
-            annot = f"{annot}\n#;  {src_line}"
-
-        # Print diff
-        if diff:
-            # Compare current and previous call stacks
-            next_call_stack = assemble_call_stack(funs, file_paths, file_lines)
-            matching_cstack_levels = matching_call_stack_levels(
-                next_call_stack, call_stack
-            )
-            matching_src_line = matching_source_line(next_call_stack, call_stack)
-
-            # If this instruction does not map to the same evaluation of the source line
-            # of the last instruction, we finalize and dump the previous hunk
-            if hunk_trace and not matching_src_line:
-                dump_hunk(hunk_tstart, hunk_sstart, hunk_trace, hunk_source)
-                # Initialize next hunk
-                hunk_tstart += len(hunk_trace.splitlines())
-                hunk_sstart += len(hunk_source.splitlines())
-                hunk_trace = ""
-                hunk_source = ""
-
-            # Update state for next iteration
-            call_stack = next_call_stack
-
-            # Assemble source part of hunk
-            if len(funs) and src_files[src_fname]:
-                for i, call in enumerate(call_stack):
-                    if i >= matching_cstack_levels:
-                        hunk_source += f"+{format_call(i, call)}"
-                if not matching_src_line:
-                    indentation = "  " * (len(call_stack) - 1)
-                    hunk_source += f"+{indentation}{file_lines[0]}: {src_line}\n"
-
-            # Assemble trace part of hunk
-            hunk_trace += f"-{line[trace_start_col:]}"
-
-        # Default: print trace interleaved with source annotations
-        else:
-            if len(annot) and annot != last:
-                of.write(annot + "\n")
-            of.write(f"      {line[trace_start_col:]}")
-            last = annot
-
-        # very simple progress
-        if not quiet:
-            prog = int(100.0 / tot_lines * lino)
-            if prog > last_prog:
-                last_prog = prog
-                sys.stdout.write(f"\b\b\b\b{prog:3d}%")
-                sys.stdout.flush()
+                last = annot
+        if progress:
+            progress()
 
     # Dump last hunk
     if diff:
-        dump_hunk(hunk_tstart, hunk_sstart, hunk_trace, hunk_source)
+        dump_hunk(of, hunk_tstart, hunk_sstart, hunk_trace, hunk_source)
+    a2l.close()
+    return len(a2l.cache)
 
-if not quiet:
-    print(" done")
-    print(adr2line.cache_info())
+
+# Lines of the text trace starting within the byte range `[begin, end)`
+def read_chunk(begin, end):
+    with open(trace, "rb") as f:
+        if begin:
+            f.seek(begin - 1)
+            f.readline()
+        while f.tell() < end:
+            line = f.readline()
+            if not line:
+                break
+            yield line.decode()
+
+
+# Worker annotating one chunk of the trace into a part of the output
+def annotate_chunk(chunk):
+    idx, begin, end = chunk
+    part = f"{output}.part{idx}"
+    with open(part, "w") as of:
+        annotate(read_chunk(begin, end), of)
+    return part
+
+
+# core functionality
+binary = gen_trace.bintrace.is_binary_trace(trace)
+jobs = args.jobs
+if binary or diff or args.start or args.end >= 0:
+    # Diffs and line ranges are sequential, binary traces have no line offsets
+    jobs = 1
+
+if jobs > 1:
+    size = os.path.getsize(trace)
+    chunks = [(i, i * size // jobs, (i + 1) * size // jobs) for i in range(jobs)]
+    with Pool(jobs) as pool, open(output, "w") as of:
+        for part in pool.imap(annotate_chunk, chunks):
+            with open(part) as pf:
+                shutil.copyfileobj(pf, of)
+            os.remove(part)
+    if not quiet:
+        print(" done")
+else:
+    if binary:
+        lines = gen_trace.annotated_lines(trace, args.dasm)
+        size = 0
+    else:
+        lines = infile = open(trace, "r")
+        size = os.path.getsize(trace)
+    if args.start or args.end >= 0:
+        lines = islice(lines, args.start, args.end if args.end >= 0 else None)
+
+    # very simple progress, by the share of the text trace consumed
+    last_prog = 0
+
+    def progress():
+        global last_prog
+        if quiet or not size:
+            return
+        prog = int(100.0 * infile.buffer.tell() / size)
+        if prog > last_prog:
+            last_prog = prog
+            sys.stdout.write(f"\b\b\b\b{prog:3d}%")
+            sys.stdout.flush()
+
+    with open(output, "w") as of:
+        resolved = annotate(lines, of, progress)
+
+    if not quiet:
+        print(" done")
+        print(f"resolved {resolved} addresses")
@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+
+# Copyright 2023 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+# Render the per-bank TCDM accesses or conflicts dumped by the testbench with
+# `+tcdm_heatmap=<cycles>` (`logs/tcdm_heatmap.csv`) as a bank x time heat
+# map. Without an output file, the heat map is printed to the terminal,
+# otherwise it is written as an SVG image.
+#
+# The Spatz VLSU ports of a core are aggregated into one requester per core,
+# and the conflicts of the DMA are not counted (its accesses are).
+#
+# Example, conflicts of the Spatz VLSUs in the first kernel window:
+#   tcdm_heatmap.py logs/tcdm_heatmap.csv -m conflicts -r vlsu -o conf.svg
+
+import argparse
+import csv
+import sys
+from collections import defaultdict
+
+SHADES = " .:-=+*#%@"
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+        "tcdm_heatmap",
+        allow_abbrev=True,
+        epilog="The VLSU ports of a core are aggregated into one `coreN_vlsu` "
+        "requester, and DMA conflicts are not counted.",
+    )
+    parser.add_argument("csv", help="CSV file written by the testbench")
+    parser.add_argument(
+        "-m",
+        "--metric",
+        choices=["accesses", "conflicts"],
+        default="conflicts",
+        help="Count to plot (default: %(default)s)",
+    )
+    parser.add_argument(
+        "-k",
+        "--kernel",
+        type=int,
+        default=0,
+        help="Kernel window to plot (default: %(default)s)",
+    )
+    parser.add_argument(
+        "-r",
+        "--requester",
+        action="append",
+        help="Only count requesters containing this string, e.g., `vlsu`, "
+        "`core0` or `dma`. Can be given multiple times.",
+    )
+    parser.add_argument(
+        "-w",
+        "--width",
+        type=int,
+        default=100,
+        help="Maximum number of time bins (default: %(default)s)",
+    )
+    parser.add_argument("-o", "--output", help="Write an SVG image to this file")
+    return parser.parse_args()
+
+
+def load(path, metric, kernel, requesters):
+    """Return the counts per (window cycle, bank) and the number of banks."""
+    counts = defaultdict(int)
+    banks = set()
+    with open(path) as f:
+        for row in csv.DictReader(f):
+            if int(row["kernel"]) != kernel:
+                continue
+            banks.add(int(row["bank"]))
+            if requesters and not any(r in row["requester"] for r in requesters):
+                continue
+            counts[(int(row["cycle"]), int(row["bank"]))] += int(row[metric])
+    return counts, max(banks) + 1 if banks else 0
+
+
+def bin_counts(counts, num_banks, width):
+    """Bin the windows into at most `width` equally long time bins."""
+    cycles = sorted({c for c, _ in counts})
+    if not cycles:
+        return [], 0, 0
+    first, last = cycles[0], cycles[-1]
+    # Bins are multiples of the window size of the testbench.
+    window = min((b - a for a, b in zip(cycles, cycles[1:])), default=1)
+    num_windows = (last - first) // window + 1
+    bin_cycles = window * -(-num_windows // width)
+    num_bins = (last - first) // bin_cycles + 1
+    grid = [[0] * num_bins for _ in range(num_banks)]
+    for (cycle, bank), n in counts.items():
+        grid[bank][(cycle - first) // bin_cycles] += n
+    return grid, first, bin_cycles
+
+
+def print_ascii(grid, first, bin_cycles, metric):
+    peak = max((max(row, default=0) for row in grid), default=0) or 1
+    print(f"{metric} per bank, {bin_cycles} cycles per column starting at "
+          f"cycle {first}, peak {peak} ('{SHADES[-1]}')")
+    for bank, row in enumerate(grid):
+        line = "".join(SHADES[(len(SHADES) - 1) * n // peak] for n in row)
+        print(f"bank {bank:3d} |{line}| {sum(row)}")
+
+
+def write_svg(path, grid, first, bin_cycles, metric):
+    cell_w, cell_h, left, top = 8, 16, 70, 30
+    num_bins = len(grid[0]) if grid else 0
+    width = left + num_bins * cell_w + 10
+    height = top + len(grid) * cell_h + 30
+    peak = max((max(row, default=0) for row in grid), default=0) or 1
+    out = [
+        f'<svg xmlns="http://www.w3.org/2000/svg" width="{width}" '
+        f'height="{height}" font-family="monospace" font-size="11">',
+        f'<text x="{left}" y="18">{metric} per bank, {bin_cycles} cycles per '
+        f"column, peak {peak}</text>",
+    ]
+    for bank, row in enumerate(grid):
+        y = top + bank * cell_h
+        out.append(f'<text x="4" y="{y + cell_h - 4}">bank {bank}</text>')
+        for i, n in enumerate(row):
+            if not n:
+                continue
+            # White to red
+            shade = 255 - 255 * n // peak
+            out.append(
+                f'<rect x="{left + i * cell_w}" y="{y}" width="{cell_w}" '
+                f'height="{cell_h}" fill="rgb(255,{shade},{shade})">'
+                f"<title>bank {bank}, cycle {first + i * bin_cycles}: "
+                f"{n}</title></rect>"
+            )
+    y = top + len(grid) * cell_h + 16
+    out.append(f'<text x="{left}" y="{y}">cycle {first}</text>')
+    out.append("</svg>")
+    with open(path, "w") as f:
+        f.write("\n".join(out) + "\n")
+
+
+def main():
+    args = parse_args()
+    counts, num_banks = load(args.csv, args.metric, args.kernel, args.requester)
+    if not num_banks:
+        print(f"No data for kernel {args.kernel} in {args.csv}", file=sys.stderr)
+        return 1
+    grid, first, bin_cycles = bin_counts(counts, num_banks, args.width)
+    if not grid:
+        grid = [[] for _ in range(num_banks)]
+    if args.output:
+        write_svg(args.output, grid, first, bin_cycles, args.metric)
+    else:
+        print_ascii(grid, first, bin_cycles, args.metric)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
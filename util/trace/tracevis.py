@@ -18,6 +18,11 @@ import os
 import sys
 from functools import lru_cache
 import argparse
+import json
+
+# Binary traces are converted by `gen_trace.py`
+sys.path.append(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+import gen_trace  # noqa: E402
 
 has_progressbar = True
 try:
@@ -57,7 +62,156 @@ BANSHEE_REGEX = r" *(\d+) (\d+) (\d+) ([0-9a-f]+) *.+ +.+# ([\w\.]*)( +)(.*)"
 # 3 -> comment
 ACC_LINE_REGEX = r" *(\d+) +(\d+) +([3M1S0U]?) *#; (.*)"
 
+# Spatz unit an instruction was issued to and the vector state, as annotated
+# by `gen_trace.py`
+# 0 -> unit
+# 1 -> vl
+# 2 -> SEW
+VEC_UNIT_REGEX = re.compile(r"(VFU|VLSU|VSLDU) <~~ vl (\d+), e(\d+)")
+
+# Functions whose instructions are shown as synchronization spans, by
+# priority. Matched against the function and the functions it is inlined in.
+SYNC_FUNCS = (
+    (re.compile(r"\b(snrt_cluster_hw_barrier|snrt_barrier|__kmpc_barrier)\b"), "barrier"),
+    (re.compile(r"\b(__kmpc_fork_call|eu_dispatch_push|partialParallelRegion)\b"), "omp fork"),
+    (re.compile(r"\beu_run_empty\b"), "omp join"),
+    (re.compile(r"\beu_event_loop\b"), "omp idle"),
+)
+
+# Lanes shown above the functions of each hart
+LANES = ("Spatz VFU", "Spatz VLSU", "Spatz VSLDU", "DMA", "sync")
+
+# Width of a Spatz FPU or memory port in bits
+SPATZ_ELEN = 64
+
 buf = []
+lanes = {}
+# Time per cycle, used to convert unit occupancies with `--time`
+period = 1
+
+
+class Lane:
+    # Aggregates the events of a lane into spans. An event extends the current
+    # span if it has the same name and starts at most `--span-gap` after it.
+    def __init__(self, pid, tid):
+        self.pid = pid
+        self.tid = tid
+        self.span = None
+        # Time the unit is done with all events added so far
+        self.free = 0
+
+    def add(self, start, end, name, detail=None, nbytes=0):
+        span = self.span
+        if not span or span["name"] != name or start > span["end"] + span_gap:
+            self.flush()
+            span = self.span = {
+                "name": name,
+                "start": start,
+                "end": end,
+                "events": {},
+                "bytes": 0,
+            }
+        span["end"] = max(span["end"], end)
+        span["bytes"] += nbytes
+        detail = detail or name
+        span["events"][detail] = span["events"].get(detail, 0) + 1
+        self.free = max(self.free, end)
+
+    def flush(self):
+        span = self.span
+        if not span:
+            return
+        events = sorted(span["events"].items(), key=lambda e: -e[1])
+        span_args = {
+            "events": sum(n for _, n in events),
+            "detail": " ".join(f"{d}:{n}" for d, n in events[:8]),
+        }
+        if span["bytes"]:
+            span_args["bytes"] = span["bytes"]
+        output_file.write(
+            json.dumps(
+                {
+                    "name": span["name"],
+                    "cat": "lane",
+                    "ph": "X",
+                    "ts": span["start"],
+                    "dur": span["end"] - span["start"],
+                    "pid": self.pid,
+                    "tid": self.tid,
+                    "args": span_args,
+                }
+            )
+            + ",\n"
+        )
+        self.span = None
+
+
+def lane(pid, tid):
+    if (pid, tid) not in lanes:
+        lanes[pid, tid] = Lane(pid, tid)
+        # Sort the lanes above the functions
+        output_file.write(
+            json.dumps(
+                {
+                    "name": "thread_sort_index",
+                    "ph": "M",
+                    "pid": pid,
+                    "tid": tid,
+                    "args": {"sort_index": LANES.index(tid) - len(LANES)},
+                }
+            )
+            + ",\n"
+        )
+    return lanes[pid, tid]
+
+
+def flush_lanes():
+    for lane_ in lanes.values():
+        lane_.flush()
+    lanes.clear()
+
+
+# Estimate how long a Spatz unit is busy with an instruction: every FPU and
+# memory port processes ELEN bits per cycle, and each unit works in order.
+def add_vector_event(pid, time, cmt, instr):
+    match = VEC_UNIT_REGEX.search(cmt)
+    if not match:
+        return
+    unit, vl, sew = match.group(1), int(match.group(2)), int(match.group(3))
+    elems_per_cycle = max(1, n_fpu * SPATZ_ELEN // sew)
+    busy = max(1, -(-vl // elems_per_cycle)) * period
+    unit_lane = lane(pid, "Spatz " + unit)
+    start = max(time, unit_lane.free)
+    nbytes = vl * sew // 8 if unit == "VLSU" else 0
+    unit_lane.add(start, start + busy, unit, instr, nbytes)
+
+
+def add_sync_event(pid, time, next_time, func, inlined):
+    for regex, name in SYNC_FUNCS:
+        if regex.search(func) or regex.search(inlined):
+            lane(pid, "sync").add(time, next_time, name, func)
+            return
+
+
+# Add the transfers of the DMA trace written next to the core trace by
+# `axi_dma_tc_snitch_fe`, if any.
+def add_dma_events(pid, filename):
+    dma_log = re.sub(r"trace_hart_([0-9a-f]+)\..*$", r"dma_trace_\1.log", filename)
+    if dma_log == filename or not os.path.exists(dma_log):
+        return
+    issued = {}
+    with open(dma_log) as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) < 4:
+                continue
+            ts = int(fields[0]) if use_time else int(fields[1])
+            if fields[2] == "issue":
+                nbytes = int(fields[6]) * int(fields[7])
+                issued[fields[3]] = (ts, nbytes, f"{fields[4]}->{fields[5]}")
+            elif fields[2] == "done" and fields[3] in issued:
+                start, nbytes, detail = issued.pop(fields[3])
+                lane(pid, "DMA").add(start, ts, "DMA", detail, nbytes)
 
 
 @lru_cache(maxsize=1024)
@@ -67,7 +221,7 @@ def addr2line_cache(addr):
 
 
 def flush(buf, hartid):
-    global output_file
+    global output_file, period
     # get function names
     pcs = [x[3] for x in buf]
     a2ls = []
@@ -88,6 +242,8 @@ def flush(buf, hartid):
         if use_time:
             next_time = int(buf[0][0])
             time = int(time)
+            if int(buf[0][1]) > int(cyc):
+                period = (next_time - time) // (int(buf[0][1]) - int(cyc)) or 1
         else:
             next_time = int(buf[0][1])
             time = int(cyc)
@@ -127,6 +283,10 @@ def flush(buf, hartid):
         pid = elf + ":hartid" + str(hartid)
         funcname = func
 
+        if not banshee:
+            add_vector_event(pid, time, cmt, instr)
+            add_sync_event(pid, time, next_time, func, inlined)
+
         # args
         arg_pc = pc
         arg_instr = instr
@@ -215,6 +375,27 @@ parser.add_argument(
     default=-1,
     help="Last line to parse",
 )
+parser.add_argument(
+    "--n-fpu",
+    metavar="<n>",
+    type=int,
+    default=4,
+    help="FPUs per Spatz, used to estimate the occupancy of its units",
+)
+parser.add_argument(
+    "--span-gap",
+    metavar="<cycles>",
+    type=int,
+    default=8,
+    help="Merge events of a lane into one span across gaps up to this length",
+)
+parser.add_argument(
+    "--dasm",
+    metavar="<path>",
+    nargs="?",
+    default="spike-dasm",
+    help="Disassembler used for binary traces (.bin, .bin.zst)",
+)
 
 args = parser.parse_args()
 
@@ -225,6 +406,8 @@ use_time = args.time
 banshee = args.banshee
 addr2line = args.addr2line
 cache = not args.no_cache
+n_fpu = args.n_fpu
+span_gap = args.span_gap
 
 print("elf:", elf, file=sys.stderr)
 print("traces:", traces, file=sys.stderr)
@@ -302,24 +485,32 @@ with open(output, "w") as output_file:
         last_time = last_cyc = 0
 
         print(f"parsing hartid {hartid} with trace {filename}", file=sys.stderr)
-        tot_lines = len(open(filename).readlines())
-        with open(filename) as f:
-            all_lines = f.readlines()[args.start : args.end]
-            # offload lookahead
-            if not banshee:
-                lah = offload_lookahead(all_lines)
-            if has_progressbar:
-                for lino, line in progressbar.progressbar(
-                    enumerate(all_lines), max_value=tot_lines
-                ):
-                    fails += parse_line(line, hartid)
-                    lines += 1
-            else:
-                for lino, line in enumerate(all_lines):
-                    fails += parse_line(line, hartid)
-                    lines += 1
-            flush(buf, hartid)
-            print(f" parsed {lines-fails} of {lines} lines", file=sys.stderr)
+        if gen_trace.bintrace.is_binary_trace(filename):
+            all_lines = list(gen_trace.annotated_lines(filename, args.dasm))
+        else:
+            with open(filename) as f:
+                all_lines = f.readlines()
+        tot_lines = len(all_lines)
+        all_lines = all_lines[args.start : args.end]
+        # offload lookahead
+        if not banshee:
+            lah = offload_lookahead(all_lines)
+        if has_progressbar:
+            for lino, line in progressbar.progressbar(
+                enumerate(all_lines), max_value=tot_lines
+            ):
+                fails += parse_line(line, hartid)
+                lines += 1
+        else:
+            for lino, line in enumerate(all_lines):
+                fails += parse_line(line, hartid)
+                lines += 1
+        flush(buf, hartid)
+        buf.clear()
+        if not banshee:
+            add_dma_events(elf + ":hartid" + str(hartid), filename)
+        flush_lanes()
+        print(f" parsed {lines-fails} of {lines} lines", file=sys.stderr)
 
     # JSON footer
     output_file.write(r"{}]}" "\n")